@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+
+import os
+import re
+import sys
+import argparse
+import threading
+import subprocess
+
+BEGIN = "# bench: begin"
+FOOTER = "# bench: done"
+FAILED = "FAILED"
+ROW_RE = re.compile(r"^(\w+) (\d+) (\d+) (\d+|FAILED)$")
+
+# with -icount shift=0 every instruction advances the virtual clock by 1 ns,
+# so a tick of the 1 MHz SP804 counter stands for 1000 instructions
+INSNS_PER_TICK = 1000
+
+def parse_table(lines):
+    """Rows of the last benchmark table, keyed by (name, size), as (iterations, ticks).
+    The ticks of a case whose calls failed are None."""
+    rows = None
+
+    for line in lines:
+        line = line.strip()
+
+        if line.endswith(BEGIN):
+            rows = {}
+            continue
+
+        if rows is None:
+            continue
+
+        if line == FOOTER:
+            return rows
+
+        match = ROW_RE.match(line)
+        if match:
+            ticks = None if match.group(4) == FAILED else int(match.group(4))
+            rows[(match.group(1), int(match.group(2)))] = (int(match.group(3)), ticks)
+
+    return rows
+
+def run_firmware(qemu, machine, elf, timeout):
+    """Boots the benchmark firmware and returns its console output up to the end of the table."""
+    cmd = [qemu, "-M", machine, "-nographic", "-monitor", "none", "-icount", "shift=0",
+           "-kernel", elf, "-serial", "stdio", "-serial", "null"]
+
+    proc = subprocess.Popen(cmd, stdin=subprocess.DEVNULL, stdout=subprocess.PIPE, text=True, errors="replace")
+    timer = threading.Timer(timeout, proc.kill)
+    timer.start()
+
+    lines = []
+    try:
+        for line in proc.stdout:
+            lines.append(line)
+            if line.strip() == FOOTER:
+                break
+    finally:
+        timer.cancel()
+        proc.kill()
+        proc.wait()
+
+    return lines
+
+def per_call(row):
+    iterations, ticks = row
+    return ticks * INSNS_PER_TICK / iterations
+
+def failed_cases(rows):
+    return [key for key, (_, ticks) in rows.items() if ticks is None]
+
+def write_baseline(filename, rows):
+    with open(filename, "w") as fout:
+        fout.write("# crypto benchmark baseline, recorded by dev/bench.py --update\n")
+        fout.write(BEGIN + "\n")
+        for (name, size), (iterations, ticks) in rows.items():
+            fout.write(f"{name} {size} {iterations} {ticks}\n")
+        fout.write(FOOTER + "\n")
+
+def compare(rows, baseline, tolerance):
+    """Prints both tables side by side, returns the number of cases slower than the tolerance allows."""
+    regressions = 0
+
+    print(f"# instructions per call (-icount shift=0), tolerance {tolerance:.1f}%")
+    print(f"{'case':24s} {'size':>6s} {'baseline':>12s} {'current':>12s} {'delta':>8s}")
+
+    for key, row in rows.items():
+        name, size = key
+        if row[1] is None:
+            print(f"{name:24s} {size:6d} {'':>12s} {FAILED:>12s}")
+            continue
+
+        current = per_call(row)
+
+        if key not in baseline:
+            print(f"{name:24s} {size:6d} {'-':>12s} {current:12.0f} {'new':>8s}")
+            continue
+
+        before = per_call(baseline[key])
+        delta = 100.0 * (current - before) / before if before else 0.0
+
+        mark = ""
+        if delta > tolerance:
+            mark = "  SLOWER"
+            regressions += 1
+        elif delta < -tolerance:
+            mark = "  faster"
+
+        print(f"{name:24s} {size:6d} {before:12.0f} {current:12.0f} {delta:+7.1f}%{mark}")
+
+    for name, size in baseline:
+        if (name, size) not in rows:
+            print(f"{name:24s} {size:6d} {per_call(baseline[(name, size)]):12.0f} {'-':>12s} {'gone':>8s}")
+
+    return regressions
+
+def main():
+    parser = argparse.ArgumentParser(description="Runs the crypto micro-benchmarks of a BENCH=1 firmware under "
+                                                 "QEMU with a deterministic instruction count and compares "
+                                                 "them against a stored baseline.")
+    parser.add_argument("elf", help="firmware built with BENCH=1")
+    parser.add_argument("baseline", help="baseline table, written by --update")
+    parser.add_argument("--qemu", default="qemu-system-arm", help="QEMU binary")
+    parser.add_argument("--machine", default="versatilepc", help="QEMU machine")
+    parser.add_argument("--timeout", type=float, default=300, help="seconds to wait for the table")
+    parser.add_argument("--tolerance", type=float, default=1.0, help="allowed slowdown per case, in percent")
+    parser.add_argument("--update", action="store_true", help="store the results as the new baseline")
+    args = parser.parse_args()
+
+    rows = parse_table(run_firmware(args.qemu, args.machine, args.elf, args.timeout))
+    if not rows:
+        print("no complete benchmark table in the firmware output", file=sys.stderr)
+        return 2
+
+    failed = failed_cases(rows)
+
+    if args.update:
+        if failed:
+            compare(rows, {}, args.tolerance)
+            print(f"\n{len(failed)} case(s) failed, baseline not written", file=sys.stderr)
+            return 1
+
+        write_baseline(args.baseline, rows)
+        print(f"baseline written to {args.baseline}")
+        return 0
+
+    if not os.path.exists(args.baseline):
+        compare(rows, {}, args.tolerance)
+        print(f"\nno baseline at {args.baseline}, record one with --update")
+        return 1 if failed else 0
+
+    with open(args.baseline, "r") as fin:
+        baseline = parse_table(fin) or {}
+    baseline = {key: row for key, row in baseline.items() if row[1] is not None}
+
+    regressions = compare(rows, baseline, args.tolerance)
+    if failed:
+        print(f"\n{len(failed)} case(s) failed")
+    if regressions:
+        print(f"\n{regressions} case(s) slower than the baseline")
+    if failed or regressions:
+        return 1
+
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
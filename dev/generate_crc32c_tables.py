@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+
+import argparse
+
+# reflected Castagnoli polynomial (0x1EDC6F41)
+POLY = 0x82F63B78
+WORDS_PER_LINE = 4
+
+def make_tables(count):
+    """Slicing tables: tables[k][n] is the CRC of byte n followed by k zero bytes."""
+    first = []
+    for n in range(256):
+        crc = n
+        for _ in range(8):
+            crc = (crc >> 1) ^ (POLY if crc & 1 else 0)
+        first.append(crc)
+
+    tables = [first]
+    for _ in range(1, count):
+        previous = tables[-1]
+        tables.append([(value >> 8) ^ first[value & 0xFF] for value in previous])
+
+    return tables
+
+def main():
+    parser = argparse.ArgumentParser(description="Generates the CRC32C slicing tables as a C header.")
+    parser.add_argument("--tables", type=int, default=8, help="number of 256-entry tables")
+    args = parser.parse_args()
+
+    tables = make_tables(args.tables)
+
+    print("/* generated by dev/generate_crc32c_tables.py, do not edit */")
+    print()
+    print(f"#define CRC32C_TABLES ( {args.tables} )")
+    print()
+    print("static const uint32_t crc32c_tables[CRC32C_TABLES][256] = {")
+    for table in tables:
+        print("    {")
+        for i in range(0, 256, WORDS_PER_LINE):
+            words = ", ".join(f"0x{value:08X}" for value in table[i:i + WORDS_PER_LINE])
+            print(f"        {words},")
+        print("    },")
+    print("};")
+
+if __name__ == "__main__":
+    main()
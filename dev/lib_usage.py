@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+
+import os
+import re
+import argparse
+import subprocess
+import collections
+
+SIZE_RE = re.compile(r"^\s*(\d+)\s+(\d+)\s+(\d+)\s+\d+\s+[0-9a-f]+\s+(\S+)")
+SECTION_RE = re.compile(r"^ (\.\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+))?$")
+WRAPPED_RE = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+)$")
+MEMBER_RE = re.compile(r"^(.*)\((.+)\)$")
+NM_MEMBER_RE = re.compile(r"^(\S+):$")
+NM_SYMBOL_RE = re.compile(r"^[0-9a-f]+\s+[A-Za-z]\s+(\S+)$")
+
+# input sections that do not end up in the image
+NOT_LOADED = (".debug", ".comment", ".ARM.attributes", ".stab")
+
+Sizes = collections.namedtuple("Sizes", ["text", "data", "bss"])
+
+def archive_sizes(size, archive):
+    """text, data and bss of each member of the archive, as reported by size (Berkeley format)."""
+    output = subprocess.check_output([size, archive], text=True)
+
+    sizes = {}
+    for line in output.splitlines():
+        match = SIZE_RE.match(line)
+        if match:
+            member = match.group(4)
+            member = MEMBER_RE.match(member).group(2) if MEMBER_RE.match(member) else os.path.basename(member)
+            sizes[member] = Sizes(int(match.group(1)), int(match.group(2)), int(match.group(3)))
+
+    return sizes
+
+def is_lto(objdump, archive):
+    """Whether the archive holds LTO objects, whose code is only generated at link time."""
+    return ".gnu.lto_" in subprocess.check_output([objdump, "-h", archive], text=True)
+
+def archive_symbols(nm, archive):
+    """Member of the archive that defines each global symbol."""
+    output = subprocess.check_output([nm, "--defined-only", archive], text=True)
+
+    owners = {}
+    member = None
+    for line in output.splitlines():
+        match = NM_MEMBER_RE.match(line)
+        if match:
+            member = match.group(1)
+            continue
+
+        match = NM_SYMBOL_RE.match(line)
+        if match and member is not None:
+            owners.setdefault(match.group(1), member)
+
+    return owners
+
+def linked_sizes_by_symbol(nm, elf, owners):
+    """Bytes each archive member contributes to the image, summed over the sized symbols of the image.
+    LTO may rename a function it clones or privatizes (foo.constprop.0, foo.lto_priv.0), the name before
+    the first dot is the one of the source."""
+    output = subprocess.check_output([nm, "-S", "--defined-only", elf], text=True)
+
+    linked = collections.Counter()
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) != 4:
+            # no size
+            continue
+
+        member = owners.get(fields[3].split(".")[0])
+        if member is not None:
+            linked[member] += int(fields[1], 16)
+
+    return linked
+
+def linked_sizes(map_file, archive):
+    """Bytes each archive member contributes to the image, from the link map."""
+    name = os.path.basename(archive)
+    linked = collections.Counter()
+
+    with open(map_file, "r") as fin:
+        lines = iter(fin.read().splitlines())
+
+    # the discarded input sections are listed before the memory map
+    for line in lines:
+        if line.startswith("Linker script and memory map"):
+            break
+
+    section = None
+    for line in lines:
+        match = SECTION_RE.match(line)
+        if match:
+            section = match.group(1)
+            if match.group(2) is None:
+                # a long section name, the rest follows on the next line
+                continue
+            size, source = int(match.group(3), 16), match.group(4)
+        else:
+            match = WRAPPED_RE.match(line)
+            if not match or section is None:
+                section = None
+                continue
+            size, source = int(match.group(2), 16), match.group(3)
+
+        member = MEMBER_RE.match(source)
+        if member and os.path.basename(member.group(1)) == name and not section.startswith(NOT_LOADED):
+            linked[member.group(2)] += size
+
+        section = None
+
+    return linked
+
+def main():
+    parser = argparse.ArgumentParser(description="Reports the size of each object of a static library "
+                                                 "and how much of it a stage firmware links in.")
+    parser.add_argument("archive", help="the static library, e.g. libmbedcrypto.a")
+    parser.add_argument("map", help="link map of the firmware")
+    parser.add_argument("elf", help="the firmware")
+    parser.add_argument("--prefix", default="arm-none-eabi-", help="toolchain prefix")
+    args = parser.parse_args()
+
+    sizes = archive_sizes(args.prefix + "size", args.archive)
+    lto = is_lto(args.prefix + "objdump", args.archive)
+
+    print(f"# {os.path.basename(args.archive)}: size of each object and its contribution to "
+          f"{os.path.splitext(os.path.basename(args.map))[0]}")
+
+    if lto:
+        # the map attributes all the code to the *.ltrans.o partitions, and the members hold no code yet
+        owners = archive_symbols(args.prefix + "gcc-nm", args.archive)
+        linked = linked_sizes_by_symbol(args.prefix + "nm", args.elf, owners)
+        print("# LTO objects: their code is generated at link time, so text/data/bss are not known per object")
+        print("# and 'linked' sums the symbols each object defines; the functions LTO inlined are not counted")
+    else:
+        linked = linked_sizes(args.map, args.archive)
+
+    print(f"# {'object':24s} {'text':>8s} {'data':>8s} {'bss':>8s} {'linked':>8s}")
+
+    total = Sizes(0, 0, 0)
+    for member in sorted(sizes, key=lambda m: (-linked[m], m)):
+        text, data, bss = sizes[member]
+        total = Sizes(total.text + text, total.data + data, total.bss + bss)
+        if lto:
+            print(f"{member:26s} {'-':>8s} {'-':>8s} {'-':>8s} {linked[member]:8d}")
+        else:
+            print(f"{member:26s} {text:8d} {data:8d} {bss:8d} {linked[member]:8d}")
+
+    if lto:
+        print(f"{'total':26s} {'-':>8s} {'-':>8s} {'-':>8s} {sum(linked.values()):8d}")
+    else:
+        print(f"{'total':26s} {total.text:8d} {total.data:8d} {total.bss:8d} {sum(linked.values()):8d}")
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,34 @@
+/**
+ * \file mbedtls_minimal_config.h
+ *
+ * \brief Minimal mbed TLS configuration shared by the stage firmwares.
+ *
+ *  Only what the firmwares use is enabled: SHA-256 (hashing and HMAC),
+ *  SHA-512 (the entropy accumulator) and HMAC_DRBG on top of the MD layer.
+ *
+ *  Each stage's dev/mbedtls_config.h defines its own extra options and then
+ *  includes this file. Both are copied next to the mbed TLS headers before
+ *  the library is built, see the stage Makefiles.
+ */
+
+#ifndef MBEDTLS_MINIMAL_CONFIG_H
+#define MBEDTLS_MINIMAL_CONFIG_H
+
+/* System support: bare metal, allocations may be redirected with mbedtls_platform_set_calloc_free() */
+#define MBEDTLS_PLATFORM_C
+#define MBEDTLS_PLATFORM_MEMORY
+#define MBEDTLS_NO_PLATFORM_ENTROPY
+
+/* Hashes. SHA-224 cannot be disabled without SHA-256, see library/sha256.c */
+#define MBEDTLS_MD_C
+#define MBEDTLS_SHA224_C
+#define MBEDTLS_SHA256_C
+#define MBEDTLS_SHA512_C
+
+/* Random generation: the firmwares register their own entropy sources */
+#define MBEDTLS_ENTROPY_C
+#define MBEDTLS_HMAC_DRBG_C
+
+#define MBEDTLS_ENTROPY_MAX_GATHER  64 /**< Maximum amount requested from entropy sources */
+
+#endif /* MBEDTLS_MINIMAL_CONFIG_H */
@@ -0,0 +1,84 @@
+# Build profiles and image reports shared by the stage firmwares.
+#
+# Included by a stage Makefile once its TARGET, BIN_DIR, OBJ_DIR, MBEDTLS_LIB_FILE, CFLAGS and tools are defined.
+# The stage compiles with $(OPT_CFLAGS) and links with $(LINK) $(LINK_FLAGS). It builds mbedTLS with
+# CFLAGS=$(LIB_CFLAGS), AR=$(LIB_AR) and RL=$(LIB_RL), and makes its objects depend on
+# $(PROFILE_STAMP) and the library on $(MBEDTLS_PROFILE_STAMP).
+#
+# BUILD_PROFILE selects:
+#   default - plain -O2, linked by ld (the historical build)
+#   size    - -Os with LTO, each function and object in its own section and
+#             unreferenced sections removed at link time
+#   speed   - -O3 with LTO
+BUILD_PROFILE ?= default
+
+# LTO needs the compiler driver to link (the linker plugin), without its startup files and libs
+LTO_LINK = $(CC) $(filter -mcpu=%, $(CFLAGS)) $(OPT_CFLAGS) -nostartfiles -nostdlib
+
+# archives of LTO objects need their symbol index written through the plugin as well
+LTO_AR = $(CC:gcc=gcc-ar)
+LTO_RL = $(CC:gcc=gcc-ranlib)
+
+ifeq ($(BUILD_PROFILE), default)
+OPT_CFLAGS = -O2
+LINK = $(LD)
+LINK_FLAGS = -Map=$(MAP_FILE)
+LIB_AR = $(AR)
+LIB_RL = $(RL)
+else ifeq ($(BUILD_PROFILE), size)
+OPT_CFLAGS = -Os -flto -ffunction-sections -fdata-sections
+LINK = $(LTO_LINK)
+LINK_FLAGS = -Wl,--gc-sections -Wl,-Map=$(MAP_FILE)
+LIB_AR = $(LTO_AR)
+LIB_RL = $(LTO_RL)
+else ifeq ($(BUILD_PROFILE), speed)
+OPT_CFLAGS = -O3 -flto
+LINK = $(LTO_LINK)
+LINK_FLAGS = -Wl,-Map=$(MAP_FILE)
+LIB_AR = $(LTO_AR)
+LIB_RL = $(LTO_RL)
+else
+$(error Unknown BUILD_PROFILE "$(BUILD_PROFILE)", expected one of: default, size, speed)
+endif
+
+# mbedTLS is built for the same core and with the same profile, so that LTO and --gc-sections reach it
+LIB_CFLAGS = $(filter -mcpu=%, $(CFLAGS)) $(OPT_CFLAGS)
+
+# records the profile the objects were built with, rewritten (and so newer) only when it changes;
+# the objects depend on it, so switching profiles rebuilds them
+PROFILE_STAMP = $(OBJ_DIR)/.build_profile
+
+# the same for the library, which every stage (and each OBJ_DIR of a stage) links against, so
+# its profile is recorded next to it rather than in OBJ_DIR
+MBEDTLS_PROFILE_STAMP = $(dir $(MBEDTLS_LIB_FILE)).build_profile
+
+.PHONY: _profile_check
+$(PROFILE_STAMP) $(MBEDTLS_PROFILE_STAMP): _profile_check
+	@mkdir -p $(dir $@)
+	@echo "$(BUILD_PROFILE)" | cmp -s - $@ || echo "$(BUILD_PROFILE)" > $@
+
+# every object reports the stack frame of its functions (.su next to the .o)
+CFLAGS += -fstack-usage
+
+MAP_FILE = $(BIN_DIR)/$(TARGET).map
+SIZE_REPORT = $(BIN_DIR)/$(TARGET).size.txt
+STACK_REPORT = $(BIN_DIR)/$(TARGET).stack.txt
+MBEDTLS_REPORT = $(BIN_DIR)/$(TARGET).mbedtls.txt
+
+# per-section sizes of the linked image, regenerated on every link
+$(SIZE_REPORT): $(BIN_DIR)/$(TARGET)
+	@echo "# $(TARGET) ($(BUILD_PROFILE) profile)" > $@
+	$(SIZE) -A -d $< >> $@
+	@# footprint of the hot code (.fast) per object, taken from the link map
+	@awk '/^\.fast / { f = 1; print "\n# .fast: " $$3 " bytes at " $$2; next } \
+	      f && /^\.[a-z]/ { f = 0 } \
+	      f && /^ \.fast/ { print $$3 "\t" $$4 }' $(MAP_FILE) >> $@
+	@cat $@
+
+# worst-case stack depth of each call chain, see dev/stack_usage.py
+$(STACK_REPORT): $(BIN_DIR)/$(TARGET)
+	python3 $(ROOT_DIR)/dev/stack_usage.py $< $(OBJ_DIR) > $@
+
+# size of each mbedTLS object and how much of it ends up in the image, see dev/lib_usage.py
+$(MBEDTLS_REPORT): $(BIN_DIR)/$(TARGET)
+	python3 $(ROOT_DIR)/dev/lib_usage.py $(MBEDTLS_LIB_FILE) $(MAP_FILE) $< > $@
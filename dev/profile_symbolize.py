@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+
+import re
+import bisect
+import argparse
+import subprocess
+import collections
+
+HEADER_RE = re.compile(r"# profile: begin=0x([0-9a-f]+) end=0x([0-9a-f]+) shift=(\d+) total=(\d+) outside=(\d+)")
+BUCKET_RE = re.compile(r"^0x([0-9a-f]+) (\d+)$")
+FOOTER = "# profile: done"
+
+def parse_dump(filename):
+    header = None
+    buckets = []
+
+    with open(filename, "r", errors="replace") as fin:
+        for line in fin:
+            line = line.strip()
+
+            match = HEADER_RE.search(line)
+            if match:
+                # only the last dump of the log is of interest
+                header = [int(match.group(1), 16), int(match.group(2), 16), int(match.group(3)),
+                          int(match.group(4)), int(match.group(5))]
+                buckets = []
+                continue
+
+            if header is None or line == FOOTER:
+                continue
+
+            match = BUCKET_RE.match(line)
+            if match:
+                buckets.append((int(match.group(1), 16), int(match.group(2))))
+
+    return header, buckets
+
+def load_symbols(nm, elf):
+    output = subprocess.check_output([nm, "-n", "-S", "--defined-only", elf], text=True)
+
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2].lower() == "t":
+            symbols.append((int(fields[0], 16), int(fields[1], 16), fields[3]))
+
+    return symbols
+
+def symbolize(symbols, address):
+    starts = [symbol[0] for symbol in symbols]
+    index = bisect.bisect_right(starts, address) - 1
+
+    if index >= 0:
+        start, size, name = symbols[index]
+        if address < start + max(size, 1):
+            return name
+
+    return "0x{:08x}".format(address)
+
+def addr2line(tool, elf, address):
+    output = subprocess.check_output([tool, "-e", elf, "-f", "-C", hex(address)], text=True)
+    return output.splitlines()[-1]
+
+def main():
+    parser = argparse.ArgumentParser(description="Symbolizes a PC-sampling profile dumped by a stage firmware "
+                                                 "built with PROFILER=1.")
+    parser.add_argument("elf", help="firmware ELF the profile was taken from")
+    parser.add_argument("log", help="serial log that contains the profile dump")
+    parser.add_argument("--lines", action="store_true", help="break buckets down to source lines as well")
+    parser.add_argument("--top", type=int, default=20, help="number of entries to show")
+    parser.add_argument("--prefix", default="arm-none-eabi-", help="toolchain prefix")
+    args = parser.parse_args()
+
+    header, buckets = parse_dump(args.log)
+    if header is None:
+        print(f"error: no profile found in `{args.log}`.")
+        exit(1)
+
+    _, _, shift, total, outside = header
+    symbols = load_symbols(args.prefix + "nm", args.elf)
+
+    functions = collections.Counter()
+    for address, samples in buckets:
+        functions[symbolize(symbols, address)] += samples
+
+    print(f"{total} samples ({outside} outside of .text), bucket size {1 << shift} bytes\n")
+    for name, samples in functions.most_common(args.top):
+        print(f"{100.0 * samples / max(total, 1):6.2f}% {samples:8d}  {name}")
+
+    if args.lines:
+        print()
+        for address, samples in sorted(buckets, key=lambda bucket: -bucket[1])[:args.top]:
+            location = addr2line(args.prefix + "addr2line", args.elf, address)
+            print(f"{100.0 * samples / max(total, 1):6.2f}% {samples:8d}  0x{address:08x}  {location}")
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+
+import os
+import re
+import argparse
+import subprocess
+import collections
+
+SU_RE = re.compile(r"^(.*):([^:\s]+)\s+(\d+)\s+([\w,]+)$")
+FUNC_RE = re.compile(r"^([0-9a-f]+) <([^>]+)>:$")
+INSN_RE = re.compile(r"^\s*([0-9a-f]+):\s+[0-9a-f]+\s+(\S+)\s*(.*)$")
+CALL_RE = re.compile(r"^([0-9a-f]+) <([^>+]+)>$")
+PUSH_RE = re.compile(r"^(?:push|stmfd|stmdb)(?:al)?\s+(?:sp!,\s*)?\{([^}]*)\}")
+BRANCH_RE = re.compile(r"^(blx|bl|bx|b)(eq|ne|cs|hs|cc|lo|mi|pl|vs|vc|hi|ls|ge|lt|gt|le|al)?$")
+SUB_SP_RE = re.compile(r"^sub(?:al)?\s+sp,\s*sp,\s*#(\d+)")
+
+# number of instructions at the start of a function searched for its prologue
+PROLOGUE_LEN = 8
+
+Function = collections.namedtuple("Function", ["frame", "flags", "callees"])
+
+def parse_stack_usage(obj_dir):
+    """Frame sizes reported by -fstack-usage, keyed by function name."""
+    frames = {}
+
+    for root, _, files in os.walk(obj_dir):
+        for filename in files:
+            if not filename.endswith(".su"):
+                continue
+
+            with open(os.path.join(root, filename), "r") as fin:
+                for line in fin:
+                    match = SU_RE.match(line.strip())
+                    if match:
+                        frames[match.group(2)] = (int(match.group(3)), match.group(4))
+
+    return frames
+
+def count_registers(reglist):
+    count = 0
+    for item in reglist.split(","):
+        item = item.strip()
+        if "-" in item:
+            first, last = item.split("-")
+            count += int(last.strip()[1:]) - int(first.strip()[1:]) + 1
+        elif item:
+            count += 1
+
+    return count
+
+def is_indirect(mnemonic, operands):
+    """Whether the instruction jumps through a register or memory (returns excluded)."""
+    branch = BRANCH_RE.match(mnemonic)
+    if branch and branch.group(1) in ("blx", "bx"):
+        return operands != "lr"
+
+    if mnemonic.startswith(("ldr", "mov")):
+        registers = [operand.strip() for operand in operands.split(",")]
+        return registers[0] == "pc" and registers[1:] != ["lr"]
+
+    return False
+
+def parse_disassembly(objdump, elf):
+    """Direct callees and an estimated frame size (from the prologue) of each function."""
+    output = subprocess.check_output([objdump, "-d", "-w", elf], text=True)
+
+    functions = {}
+    starts = {}
+    name = None
+
+    for line in output.splitlines():
+        match = FUNC_RE.match(line)
+        if match:
+            name = match.group(2)
+            starts[int(match.group(1), 16)] = name
+            functions[name] = { "insns": 0, "frame": 0, "callees": set(), "tail": set(), "indirect": False }
+            continue
+
+        match = INSN_RE.match(line)
+        if name is None or not match:
+            continue
+
+        func = functions[name]
+        mnemonic, operands = match.group(2), match.group(3).split(";")[0].strip()
+        func["insns"] += 1
+
+        if func["insns"] <= PROLOGUE_LEN:
+            text = f"{mnemonic} {operands}"
+            push = PUSH_RE.match(text)
+            if push:
+                func["frame"] += 4 * count_registers(push.group(1))
+            sub = SUB_SP_RE.match(text)
+            if sub:
+                func["frame"] += int(sub.group(1))
+
+        branch = BRANCH_RE.match(mnemonic)
+        call = CALL_RE.match(operands)
+
+        if branch and call:
+            if branch.group(1) in ("bl", "blx"):
+                func["callees"].add(call.group(2))
+            elif branch.group(1) == "b":
+                # a branch to the start of another function is a tail call
+                func["tail"].add(int(call.group(1), 16))
+        elif is_indirect(mnemonic, operands):
+            func["indirect"] = True
+
+    for name, func in functions.items():
+        func["callees"].update(starts[address] for address in func["tail"] if address in starts)
+        func["callees"].discard(name)
+
+    return functions
+
+def build_graph(frames, disassembly):
+    graph = {}
+
+    for name, func in disassembly.items():
+        flags = ""
+        if name in frames:
+            frame, qualifier = frames[name]
+            if qualifier != "static":
+                flags += "D"
+        else:
+            frame = func["frame"]
+            flags += "E"
+
+        if func["indirect"]:
+            flags += "I"
+
+        graph[name] = Function(frame, flags, sorted(callee for callee in func["callees"] if callee != name))
+
+    return graph
+
+def worst_case(graph, name, memo, active):
+    """Deepest call chain starting at 'name', as (bytes, chain, recursive)."""
+    if name in memo:
+        return memo[name]
+
+    if name in active:
+        return 0, [name + " (recursion)"], True
+
+    func = graph.get(name)
+    if func is None:
+        return 0, [name + " (unknown)"], False
+
+    active.add(name)
+
+    best = (0, [], False)
+    for callee in func.callees:
+        depth, chain, recursive = worst_case(graph, callee, memo, active)
+        if depth > best[0] or not best[1]:
+            best = (depth, chain, recursive or best[2])
+        else:
+            best = (best[0], best[1], recursive or best[2])
+
+    active.discard(name)
+
+    result = (func.frame + best[0], [name] + best[1], best[2])
+    memo[name] = result
+    return result
+
+def main():
+    parser = argparse.ArgumentParser(description="Aggregates -fstack-usage output of a stage firmware into "
+                                                 "worst-case call-chain stack depths.")
+    parser.add_argument("elf", help="linked firmware ELF")
+    parser.add_argument("obj_dir", help="directory searched for the .su files")
+    parser.add_argument("--top", type=int, default=0, help="number of roots to show, all by default")
+    parser.add_argument("--prefix", default="arm-none-eabi-", help="toolchain prefix")
+    args = parser.parse_args()
+
+    frames = parse_stack_usage(args.obj_dir)
+    graph = build_graph(frames, parse_disassembly(args.prefix + "objdump", args.elf))
+
+    called = set(callee for func in graph.values() for callee in func.callees)
+    roots = [name for name in graph if name not in called]
+
+    memo = {}
+    results = sorted(((name,) + worst_case(graph, name, memo, set()) for name in roots), key=lambda r: -r[1])
+    if args.top > 0:
+        results = results[:args.top]
+
+    print(f"# stack usage: {os.path.basename(args.elf)}")
+    print("# flags: D - dynamic or bounded frame, E - frame estimated from the prologue (no .su),")
+    print("#        I - indirect calls not followed, R - recursion, depth is a lower bound")
+    print("# roots are functions without direct callers: entry points, ISRs and other")
+    print("# function pointer targets. The IRQ stack needs the deepest ISR chain plus irq_handler.")
+    print()
+
+    for name, depth, chain, recursive in results:
+        flags = "".join(sorted(set("".join(graph[link].flags for link in chain if link in graph))))
+        if recursive:
+            flags += "R"
+        print(f"{depth:8d}  {flags:4s}  " + " -> ".join(chain))
+
+if __name__ == '__main__':
+    main()
@@ -1,5 +1,7 @@
 .org 0
 
+.include "halt.inc"
+
 .section .init
 .code 32
 
@@ -7,7 +9,7 @@
 entry_point:
     LDR sp, =stack_top
     BL main
-    B .
+    HALT
 
 .section .secret
 .word 0xaabbccdd
@@ -7,6 +7,9 @@
 #define CPU_CLOCK_HZ                ( 1000000 )
 #define TICK_RATE_HZ                ( 1000 )
 
+/* Base address of the status and system control registers (see chapter 4 of the DUI0225D): */
+#define BSP_SYSCTL_BASE_ADDRESS     ( 0x10000000 )
+
 /* Base address of the Primary Interrupt Controller (see page 4-44 of the DUI0225D): */
 #define BSP_PIC_BASE_ADDRESS        ( 0x10140000 )
 
@@ -67,4 +70,12 @@
  */
 #define BSP_VERIFIER_BASE_ADDRESS   ( 0x101f6000 )
 
+/*
+ * Base address and IRQ of the SHA-256 accelerator, modelled by
+ * stages/stage9/dev/qemu.patch on the versatilepc only
+ */
+#define BSP_HASH_BASE_ADDRESS       ( 0x101f7000 )
+
+#define BSP_HASH_IRQ                ( 19 )
+
 #endif /* _BSP_H_ */
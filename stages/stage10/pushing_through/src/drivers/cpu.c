@@ -0,0 +1,187 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "cpu.h"
+
+/*
+ * Bit masks for the CP15 Control Register (c1).
+ *
+ * For description of each control register's bit, see chapter 2 of the DDI0222:
+ *   0: M (MMU enable)
+ *   2: C (D-cache enable)
+ *   3: W (write buffer enable, should be one)
+ *  12: I (I-cache enable)
+ *  13: V (high exception vectors at 0xFFFF0000)
+ */
+#define CP15_CTL_M              ( 0x00000001 )
+#define CP15_CTL_C              ( 0x00000004 )
+#define CP15_CTL_W              ( 0x00000008 )
+#define CP15_CTL_I              ( 0x00001000 )
+#define CP15_CTL_V              ( 0x00002000 )
+
+/*
+ * First-level section descriptor fields, see chapter 3 of the DDI0222:
+ *   1:0  0b10 (section)
+ *   2:   B (bufferable)
+ *   3:   C (cacheable)
+ *   4:   should be one
+ *   8:5  domain
+ *  11:10 AP (access permissions, 0b11: read/write in all modes)
+ *  31:20 section base address
+ */
+#define SECTION_TYPE            ( 0x00000012 )
+#define SECTION_B               ( 0x00000004 )
+#define SECTION_C               ( 0x00000008 )
+#define SECTION_AP_RW           ( 0x00000C00 )
+#define SECTION_SHIFT           ( 20 )
+
+#define NR_SECTIONS             ( 4096 )
+
+/* SDRAM occupies the first 256 sections, everything above is peripherals and flash */
+#define NR_SDRAM_SECTIONS       ( 256 )
+
+/*
+ * First-level coarse page table descriptor and second-level small page
+ * descriptor fields, see chapter 3 of the DDI0222:
+ *   coarse:     1:0 0b01, 4: should be one, 31:10 page table base address
+ *   small page: 1:0 0b10, 2: B, 3: C, 11:4 AP0-AP3 (0b11 each), 31:12 page base address
+ */
+#define COARSE_TYPE             ( 0x00000011 )
+#define SMALL_PAGE_TYPE         ( 0x00000002 )
+#define SMALL_PAGE_AP_RW        ( 0x00000FF0 )
+#define SMALL_PAGE_MASK         ( 0xFFFFF000 )
+#define SMALL_PAGE_SHIFT        ( 12 )
+
+#define NR_COARSE_ENTRIES       ( 256 )
+
+/* The high exception vectors reside at 0xFFFF0000 */
+#define HIGH_VECTORS_ADDR       ( 0xFFFF0000 )
+
+/* Domain 0 as a client, i.e. accesses are checked against the AP bits */
+#define DACR_DOMAIN0_CLIENT     ( 0x00000001 )
+
+#ifdef CONFIG_MMU
+/* The translation table base must be aligned to 16 kB */
+static uint32_t __ttb[NR_SECTIONS] __attribute__((aligned(16384)));
+#endif
+
+#ifdef CONFIG_HIGH_VECTORS
+/* The second-level table that maps the vectors, a coarse table must be aligned to 1 kB */
+static uint32_t __hivecTable[NR_COARSE_ENTRIES] __attribute__((aligned(1024)));
+
+/* start of the vector table, provided by startup.s and placed at the 4 kB aligned load address */
+extern const uint32_t vectors_start[];
+#endif
+
+void cpu_waitForInterrupt(void)
+{
+    /*
+     * ARMv5 has no WFI instruction, the ARM926EJ-S implements the
+     * "Wait for interrupt" operation as a write to the CP15 register c7
+     * (c7, c0, 4), see chapter 2 of the DDI0222. The written value should be zero.
+     */
+    __asm volatile("MCR p15, 0, %0, c7, c0, 4" : : "r" (0) : "memory");
+}
+
+#ifdef CONFIG_MMU
+void cpu_enableMmu(void)
+{
+    /* flat mapping, strongly ordered (neither cacheable nor bufferable) by default */
+    for (uint32_t i = 0; i < NR_SECTIONS; i++)
+    {
+        __ttb[i] = (i << SECTION_SHIFT) | SECTION_AP_RW | SECTION_TYPE;
+
+        if (i < NR_SDRAM_SECTIONS)
+        {
+            __ttb[i] |= SECTION_C | SECTION_B;
+        }
+    }
+
+#ifdef CONFIG_HIGH_VECTORS
+    /*
+     * Instead of copying the vectors to 0x00000000, the page holding the linked
+     * vector table is mapped to 0xFFFF0000, the rest of that megabyte faults.
+     */
+    const uint32_t hivec = HIGH_VECTORS_ADDR;
+
+    __hivecTable[(hivec >> SMALL_PAGE_SHIFT) % NR_COARSE_ENTRIES] =
+        ((uint32_t) vectors_start & SMALL_PAGE_MASK) | SMALL_PAGE_AP_RW | SECTION_C | SECTION_B | SMALL_PAGE_TYPE;
+    __ttb[hivec >> SECTION_SHIFT] = (uint32_t) __hivecTable | COARSE_TYPE;
+#endif
+
+    /* start with clean caches and TLBs, the table must have reached memory */
+    cpu_drainWriteBuffer();
+    __asm volatile("MCR p15, 0, %0, c7, c7, 0" : : "r" (0) : "memory");   /* invalidate both caches */
+    __asm volatile("MCR p15, 0, %0, c8, c7, 0" : : "r" (0) : "memory");   /* invalidate both TLBs */
+
+    __asm volatile("MCR p15, 0, %0, c2, c0, 0" : : "r" (__ttb) : "memory");                 /* Translation Table Base */
+    __asm volatile("MCR p15, 0, %0, c3, c0, 0" : : "r" (DACR_DOMAIN0_CLIENT) : "memory");   /* Domain Access Control */
+
+    uint32_t ctl;
+    __asm volatile("MRC p15, 0, %0, c1, c0, 0" : "=r" (ctl));
+    ctl |= CP15_CTL_M | CP15_CTL_C | CP15_CTL_W | CP15_CTL_I;
+#ifdef CONFIG_HIGH_VECTORS
+    ctl |= CP15_CTL_V;
+#endif
+    __asm volatile("MCR p15, 0, %0, c1, c0, 0" : : "r" (ctl) : "memory");
+}
+#endif
+
+void cpu_cleanDCacheRange(const void* addr, size_t len)
+{
+    uint32_t mva = (uint32_t) addr & ~(CPU_CACHE_LINE_SIZE - 1);
+    const uint32_t end = (uint32_t) addr + len;
+
+    for ( ; mva < end; mva += CPU_CACHE_LINE_SIZE)
+    {
+        __asm volatile("MCR p15, 0, %0, c7, c10, 1" : : "r" (mva) : "memory");
+    }
+
+    cpu_drainWriteBuffer();
+}
+
+void cpu_invalidateDCacheRange(void* addr, size_t len)
+{
+    uint32_t mva = (uint32_t) addr & ~(CPU_CACHE_LINE_SIZE - 1);
+    const uint32_t end = (uint32_t) addr + len;
+
+    for ( ; mva < end; mva += CPU_CACHE_LINE_SIZE)
+    {
+        __asm volatile("MCR p15, 0, %0, c7, c6, 1" : : "r" (mva) : "memory");
+    }
+}
+
+void cpu_flushDCacheRange(void* addr, size_t len)
+{
+    uint32_t mva = (uint32_t) addr & ~(CPU_CACHE_LINE_SIZE - 1);
+    const uint32_t end = (uint32_t) addr + len;
+
+    for ( ; mva < end; mva += CPU_CACHE_LINE_SIZE)
+    {
+        __asm volatile("MCR p15, 0, %0, c7, c14, 1" : : "r" (mva) : "memory");
+    }
+
+    cpu_drainWriteBuffer();
+}
+
+void cpu_flushDCache(void)
+{
+    /*
+     * "Test, clean and invalidate" operates on one dirty line per iteration
+     * and sets the Z flag once the whole D-cache is clean.
+     */
+    __asm volatile("1: MRC p15, 0, APSR_nzcv, c7, c14, 3\n"
+                   "   BNE 1b" : : : "cc", "memory");
+
+    cpu_drainWriteBuffer();
+}
+
+void cpu_invalidateICache(void)
+{
+    __asm volatile("MCR p15, 0, %0, c7, c5, 0" : : "r" (0) : "memory");
+}
+
+void cpu_drainWriteBuffer(void)
+{
+    __asm volatile("MCR p15, 0, %0, c7, c10, 4" : : "r" (0) : "memory");
+}
@@ -0,0 +1,82 @@
+#ifndef _CPU_H_
+#define _CPU_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Size of a cache line of both ARM926EJ-S caches */
+#define CPU_CACHE_LINE_SIZE     ( 32 )
+
+/**
+ * Puts the core into its low power state until an interrupt is requested.
+ *
+ * The core wakes up on a pending IRQ or FIQ even if the interrupts are masked
+ * in the CPSR. That allows the caller to mask them, check its wake-up condition
+ * and only then wait, without losing an interrupt that arrives in between.
+ *
+ * @note must be called from a privileged mode
+ */
+void cpu_waitForInterrupt(void);
+
+/**
+ * Builds a flat (virtual == physical) translation table of 1 MB sections and
+ * enables the MMU, the I-cache, the D-cache and the write buffer.
+ *
+ * SDRAM (0x00000000 - 0x0FFFFFFF) is mapped cacheable and bufferable,
+ * everything else, i.e. the peripherals at 0x10000000 and above and the flash,
+ * is mapped strongly ordered.
+ *
+ * If built with CONFIG_HIGH_VECTORS, the page holding the vector table is also
+ * mapped to 0xFFFF0000 and the high vectors are selected, so the table need
+ * not be copied to 0x00000000.
+ *
+ * The translation table lives in .bss, so this must be called after .bss is cleared.
+ * Only available if built with CONFIG_MMU.
+ */
+void cpu_enableMmu(void);
+
+/**
+ * Writes dirty D-cache lines covering the range back to memory,
+ * e.g. before a DMA master reads the buffer. The lines remain valid.
+ *
+ * @param addr - start of the range
+ * @param len - length of the range in bytes
+ */
+void cpu_cleanDCacheRange(const void* addr, size_t len);
+
+/**
+ * Discards D-cache lines covering the range without writing them back,
+ * e.g. before the CPU reads a buffer written by a DMA master.
+ *
+ * @note partial lines at both ends of the range are discarded too,
+ *       so DMA buffers should be aligned to CPU_CACHE_LINE_SIZE.
+ *
+ * @param addr - start of the range
+ * @param len - length of the range in bytes
+ */
+void cpu_invalidateDCacheRange(void* addr, size_t len);
+
+/**
+ * Writes back and discards D-cache lines covering the range.
+ *
+ * @param addr - start of the range
+ * @param len - length of the range in bytes
+ */
+void cpu_flushDCacheRange(void* addr, size_t len);
+
+/**
+ * Writes back and discards the whole D-cache.
+ */
+void cpu_flushDCache(void);
+
+/**
+ * Discards the whole I-cache, e.g. after code has been written to memory.
+ */
+void cpu_invalidateICache(void);
+
+/**
+ * Waits until the write buffer is drained into memory.
+ */
+void cpu_drainWriteBuffer(void);
+
+#endif /* _CPU_H_ */
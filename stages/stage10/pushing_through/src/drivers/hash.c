@@ -0,0 +1,119 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "hash.h"
+
+#include "bsp.h"
+#include "cpu.h"
+
+/* Value of the ID register, "SHA2" */
+#define HASH_ID             ( 0x53484132 )
+
+/* Bit masks for the Control Register */
+#define CTL_START           ( 0x00000001 )
+#define CTL_IRQ_EN          ( 0x00000002 )
+
+/* Bit masks for the Status Register, bits are cleared by writing 1s */
+#define STATUS_DONE         ( 0x00000001 )
+#define STATUS_ERROR        ( 0x00000002 )
+
+/* Number of memory regions hashed in a row */
+#define NR_REGIONS          ( 2 )
+
+typedef struct _HASH_REGION_REGS
+{
+    uint32_t SRC;                   /* Source Address Register, physical address of the region */
+    uint32_t LEN;                   /* Length Register, length of the region in bytes, 0 to skip it */
+} HASH_REGION_REGS;
+
+/*
+ * 32-bit registers of the accelerator, relative to its base address.
+ * See vpc_hash_read() and vpc_hash_write() in stages/stage9/dev/qemu.patch.
+ */
+typedef struct _VERSATILE_PC_HASH_REGS
+{
+    const uint32_t ID;              /* ID Register, read only */
+    uint32_t CTRL;                  /* Control Register, START is write only */
+    uint32_t STATUS;                /* Status Register, write 1 to clear */
+    const uint32_t Reserved;        /* Reserved, should not be modified */
+    HASH_REGION_REGS REGION[NR_REGIONS];
+    const uint32_t DIGEST[HASH_DIGEST_SIZE / sizeof(uint32_t)];    /* Digest Registers, in byte order, read only */
+} VERSATILE_PC_HASH_REGS;
+
+static volatile VERSATILE_PC_HASH_REGS* const pReg = (VERSATILE_PC_HASH_REGS*) (BSP_HASH_BASE_ADDRESS);
+
+static int8_t __present = 0;
+static int8_t __enabled = 1;
+
+void hash_init(void)
+{
+    /* nothing is mapped at the address on other machines, reads return zeroes */
+    __present = (pReg->ID == HASH_ID);
+
+    if (__present)
+    {
+        /* the driver polls, the done interrupt (BSP_HASH_IRQ) is not used */
+        pReg->CTRL = 0;
+        pReg->STATUS = STATUS_DONE | STATUS_ERROR;
+    }
+}
+
+int8_t hash_isPresent(void)
+{
+    return __present;
+}
+
+void hash_setEnabled(int8_t enabled)
+{
+    __enabled = (enabled != 0);
+}
+
+int8_t hash_isEnabled(void)
+{
+    return __present && __enabled;
+}
+
+int8_t hash_sha256(const uint8_t* head, size_t headLen, const uint8_t* data, size_t len, uint8_t* digest)
+{
+    /* sanity checks */
+    if (!hash_isEnabled() || (digest == NULL) || ((head == NULL) && (headLen != 0)) || ((data == NULL) && (len != 0)))
+    {
+        return -1;
+    }
+
+#ifdef CONFIG_MMU
+    /* the accelerator reads memory directly, past the D-cache */
+    cpu_cleanDCacheRange(head, headLen);
+    cpu_cleanDCacheRange(data, len);
+#endif
+
+    /* the MMU maps memory flat, virtual addresses are physical ones */
+    pReg->REGION[0].SRC = (uint32_t) head;
+    pReg->REGION[0].LEN = headLen;
+    pReg->REGION[1].SRC = (uint32_t) data;
+    pReg->REGION[1].LEN = len;
+
+    pReg->CTRL = CTL_START;
+
+    uint32_t status = 0;
+    while (((status = pReg->STATUS) & STATUS_DONE) == 0)
+    {
+        /* wait for completion */
+    }
+
+    pReg->STATUS = STATUS_DONE | STATUS_ERROR;
+
+    if (status & STATUS_ERROR)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < sizeof(pReg->DIGEST) / sizeof(pReg->DIGEST[0]); i++)
+    {
+        const uint32_t word = pReg->DIGEST[i];
+        memcpy(digest + i * sizeof(word), &word, sizeof(word));
+    }
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef _HASH_H_
+#define _HASH_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Size of a SHA-256 digest produced by the accelerator */
+#define HASH_DIGEST_SIZE    ( 32 )
+
+/**
+ * Initializes the SHA-256 accelerator driver: probes for the controller
+ * and clears its status.
+ *
+ * The accelerator only exists on the versatilepc machine built from
+ * stages/stage9/dev/qemu.patch. Without it, all hash_sha256() calls fail
+ * and the callers are expected to hash in software.
+ */
+void hash_init(void);
+
+/**
+ * Checks whether the accelerator responds at BSP_HASH_BASE_ADDRESS.
+ *
+ * @return 0 if absent, a nonzero value (typically 1) if the accelerator is present
+ */
+int8_t hash_isPresent(void);
+
+/**
+ * Enables or disables the use of the accelerator (enabled by default). While
+ * it is disabled, hash_sha256() fails as if it was absent, so that the
+ * software path can be forced, e.g. to benchmark it.
+ *
+ * @param enabled - 0 to disable the accelerator, a nonzero value to enable it
+ */
+void hash_setEnabled(int8_t enabled);
+
+/**
+ * @return a nonzero value if the accelerator is present and enabled, 0 otherwise
+ */
+int8_t hash_isEnabled(void);
+
+/**
+ * Computes the SHA-256 digest of 'head' followed by 'data' on the accelerator,
+ * which reads both straight from memory. Either part may be empty, the
+ * digest is ready when the function returns (it polls for completion).
+ *
+ * @param head - first part of the message, may be NULL if 'headLen' is 0
+ * @param headLen - length of the first part in bytes
+ * @param data - second part of the message, may be NULL if 'len' is 0
+ * @param len - length of the second part in bytes
+ * @param digest - where the HASH_DIGEST_SIZE bytes of the digest are stored
+ *
+ * @return 0 if successful, -1 if the accelerator is absent, disabled or failed
+ */
+int8_t hash_sha256(const uint8_t* head, size_t headLen, const uint8_t* data, size_t len, uint8_t* digest);
+
+#endif /* _HASH_H_ */
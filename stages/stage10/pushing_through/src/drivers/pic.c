@@ -7,6 +7,8 @@
 #include "regutil.h"
 
 #include "../auth.h"
+#include "../sections.h"
+#include "../utils/atomic.h"
 
 /*
  * 32-bit registers of the Primary Interrupt Controller,
@@ -64,6 +66,11 @@ typedef struct _isrVectRecord
 
 static isrVectRecord __irqVect[NR_VECTORS];
 
+#ifdef CONFIG_PROFILER
+/* address of the instruction interrupted by the IRQ being currently serviced */
+static volatile uint32_t __irqInterruptedAddr;
+#endif
+
 void irq_enableIrqMode(void)
 {
     /*
@@ -71,9 +78,13 @@ void irq_enableIrqMode(void)
      * must be cleared to 0. See pp. 2-15 to 2-17 of the DDI0222 for more details.
      * The CSPR can only be accessed using assembler.
      */
-    __asm volatile("MRS r0, cpsr");        /* Read in the CPSR register. */
-    __asm volatile("BIC r0, r0, #0x80");   /* Clear bit 8, (0x80) -- Causes IRQs to be enabled. */
-    __asm volatile("MSR cpsr_c, r0");      /* Write it back to the CPSR register */
+    uint32_t cpsr;
+
+    /* a single statement, so that the compiler allocates the register and keeps the order */
+    __asm volatile("MRS %0, cpsr\n"          /* Read in the CPSR register. */
+                   "BIC %0, %0, #0x80\n"     /* Clear bit 8, (0x80) -- Causes IRQs to be enabled. */
+                   "MSR cpsr_c, %0"          /* Write it back to the CPSR register */
+                   : "=&r" (cpsr) : : "memory");
 }
 
 void irq_disableIrqMode(void)
@@ -83,9 +94,12 @@ void irq_disableIrqMode(void)
      * must be set t1 0. See pp. 2-15 to 2-17 of the DDI0222 for more details.
      * The CSPR can only be accessed using assembler.
      */
-    __asm volatile("MRS r0, cpsr");       /* Read in the CPSR register. */
-    __asm volatile("ORR r0, r0, #0xC0");  /* Disable IRQ and FIQ exceptions. */
-    __asm volatile("MSR cpsr_c, r0");     /* Write it back to the CPSR register. */
+    uint32_t cpsr;
+
+    __asm volatile("MRS %0, cpsr\n"          /* Read in the CPSR register. */
+                   "ORR %0, %0, #0xC0\n"     /* Disable IRQ and FIQ exceptions. */
+                   "MSR cpsr_c, %0"          /* Write it back to the CPSR register. */
+                   : "=&r" (cpsr) : : "memory");
 }
 
 /*
@@ -121,8 +135,19 @@ static void __defaultVectorIsr(void)
  * for testing purposes only, in a real world application, only one mode should be selected
  * and implemented.
  */
-void __attribute__((interrupt("irq"))) irq_handler()
+FAST_TEXT void __attribute__((interrupt("irq"))) irq_handler()
 {
+#ifdef CONFIG_PROFILER
+    /*
+     * The prologue generated for interrupt("irq") has already subtracted 4 from
+     * the IRQ-mode LR, so it holds the address of the interrupted instruction.
+     * It must be captured before any call clobbers it.
+     */
+    uint32_t lr;
+    __asm volatile("MOV %0, lr" : "=r" (lr));
+    __irqInterruptedAddr = lr;
+#endif
+
     /*
      * Vectored implementation, a.k.a. "Vectored interrupt flow sequence", described
      * on page 2-9 of DDI0181.
@@ -145,6 +170,13 @@ void __attribute__((interrupt("irq"))) irq_handler()
     pPicReg->VICVECTADDR = ULFF;
 }
 
+#ifdef CONFIG_PROFILER
+uint32_t irq_getInterruptedAddr(void)
+{
+    return __irqInterruptedAddr;
+}
+#endif
+
 void pic_init(void)
 {
     /* All interrupt request lines generate IRQ interrupts: */
@@ -221,6 +253,27 @@ void pic_disableAllInterrupts(void)
     pPicReg->VICINTENCLEAR = ULFF;
 }
 
+void pic_raiseSoftwareInterrupt(uint8_t irq)
+{
+    if (irq < NR_VECTORS)
+    {
+        /*
+         * See description of VICSOFTINT in DDI0181.
+         * 0-bits have no effect, so the register can be written directly.
+         */
+        pPicReg->VICSOFTINT = HWREG_SINGLE_BIT_MASK(irq);
+    }
+}
+
+void pic_clearSoftwareInterrupt(uint8_t irq)
+{
+    if (irq < NR_VECTORS)
+    {
+        /* See description of VICSOFTINTCLEAR in DDI0181: */
+        pPicReg->VICSOFTINTCLEAR = HWREG_SINGLE_BIT_MASK(irq);
+    }
+}
+
 int8_t pic_isInterruptEnabled(uint8_t irq)
 {
     /* See description of VICINTENCLEAR, page 3-7 of DDI0181: */
@@ -274,6 +327,9 @@ int8_t pic_registerIrq(uint8_t irq, pVectoredIsrPrototype addr, uint8_t priority
         return -1;
     }
 
+    /* the table and the vector registers must not be seen half shifted by an IRQ */
+    const atomic_state_t state = atomic_enter_critical();
+
     /*
      * The priority table is traversed and two values are obtained:
      * - irqPos: index of the existing 'irq' or the first "empty" line
@@ -347,6 +403,8 @@ int8_t pic_registerIrq(uint8_t irq, pVectoredIsrPrototype addr, uint8_t priority
     pPicReg->VICVECTCNTLn[prPos] = irq | BM_VECT_ENABLE_BIT;
     pPicReg->VICVECTADDRn[prPos] = (uint32_t) addr;
 
+    atomic_exit_critical(state);
+
     return prPos;
 }
 
@@ -358,6 +416,8 @@ void pic_unregisterIrq(uint8_t irq)
         return;
     }
 
+    const atomic_state_t state = atomic_enter_critical();
+
     /* Find the 'irq' in the priority table: */
     uint8_t pos = 0;
 
@@ -372,6 +432,7 @@ void pic_unregisterIrq(uint8_t irq)
     /* Nothing to do if IRQ has not been found: */
     if (pos >= NR_VECTORS)
     {
+        atomic_exit_critical(state);
         return;
     }
 
@@ -400,10 +461,14 @@ void pic_unregisterIrq(uint8_t irq)
     __irqVect[NR_VECTORS - 1].irq = -1;               /* no IRQ assigned */
     __irqVect[NR_VECTORS - 1].isr = &__irq_dummyISR;  /* dummy ISR routine */
     __irqVect[NR_VECTORS - 1].priority = -1;          /* lowest priority */
+
+    atomic_exit_critical(state);
 }
 
 void pic_unregisterAllIrqs(void)
 {
+    const atomic_state_t state = atomic_enter_critical();
+
     /* Clear all entries in the priority table */
     for (uint8_t i = 0; i < NR_VECTORS; i++)
     {
@@ -414,4 +479,6 @@ void pic_unregisterAllIrqs(void)
         pPicReg->VICVECTCNTLn[i] = UL0;
         pPicReg->VICVECTADDRn[i] = (uint32_t) &__irqVect[i].isr;
     }
+
+    atomic_exit_critical(state);
 }
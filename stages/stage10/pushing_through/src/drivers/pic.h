@@ -20,6 +20,16 @@ void irq_enableIrqMode(void);
  */
 void irq_disableIrqMode(void);
 
+#ifdef CONFIG_PROFILER
+/**
+ * Address of the instruction that was interrupted by the IRQ being currently serviced.
+ * Only meaningful when called from within an ISR.
+ *
+ * @return address of the interrupted instruction
+ */
+uint32_t irq_getInterruptedAddr(void);
+#endif
+
 /**
  * Initializes the primary interrupt controller to default settings.
  *
@@ -52,6 +62,25 @@ void pic_disableInterrupt(uint8_t irq);
  */
 void pic_disableAllInterrupts(void);
 
+/**
+ * Raise a software generated interrupt on the specified interrupt request line.
+ * It is serviced exactly like the peripheral's own request until it is cleared.
+ *
+ * Nothing is done if 'irq' is invalid, i.e. equal or greater than 32.
+ *
+ * @param irq - interrupt number (must be smaller than 32)
+ */
+void pic_raiseSoftwareInterrupt(uint8_t irq);
+
+/**
+ * Clear a software generated interrupt on the specified interrupt request line.
+ *
+ * Nothing is done if 'irq' is invalid, i.e. equal or greater than 32.
+ *
+ * @param irq - interrupt number (must be smaller than 32)
+ */
+void pic_clearSoftwareInterrupt(uint8_t irq);
+
 /**
  * Checks whether the interrupt request line for the requested interrupt is enabled.
  *
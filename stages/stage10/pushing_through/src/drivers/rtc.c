@@ -0,0 +1,105 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "rtc.h"
+
+#include "bsp.h"
+#include "regutil.h"
+
+/*
+ * Bit masks for the Control Register (RTCCR).
+ *
+ * See chapter 3 of DDI0224:
+ *   31:1 reserved
+ *   0: RTC start (once set, the counter can only be stopped by a reset)
+ */
+#define CTL_START          ( 0x00000001 )
+
+/*
+ * Bit mask of the match interrupt, shared by RTCIMSC, RTCRIS, RTCMIS and RTCICR.
+ */
+#define INT_MATCH          ( 0x00000001 )
+
+/*
+ * 32-bit registers of the real time clock controller,
+ * relative to the controller's base address:
+ * See chapter 3 of DDI0224.
+ */
+typedef struct _PL031_RTC_REGS
+{
+    const uint32_t RTCDR;             /* Data Register, read only */
+    uint32_t RTCMR;                   /* Match Register */
+    uint32_t RTCLR;                   /* Load Register */
+    uint32_t RTCCR;                   /* Control Register */
+    uint32_t RTCIMSC;                 /* Interrupt Mask Set/Clear Register */
+    const uint32_t RTCRIS;            /* Raw Interrupt Status Register, read only */
+    const uint32_t RTCMIS;            /* Masked Interrupt Status Register, read only */
+    uint32_t RTCICR;                  /* Interrupt Clear Register, write only */
+    const uint32_t Reserved1[1008];   /* Reserved, should not be modified */
+    const uint32_t RTCPERIPHID[4];    /* Peripheral Identification Registers, read only */
+    const uint32_t RTCPCELLID[4];     /* PrimeCell Identification Registers, read only */
+} PL031_RTC_REGS;
+
+static volatile PL031_RTC_REGS* const pReg = (PL031_RTC_REGS*) (BSP_RTC_BASE_ADDRESS);
+
+void rtc_init(void)
+{
+    /* By default, the match interrupt is masked out and cleared: */
+    HWREG_CLEAR_BITS(pReg->RTCIMSC, INT_MATCH);
+    pReg->RTCICR = INT_MATCH;
+
+    /* Start the counter, it keeps its current value if already running */
+    HWREG_SET_BITS(pReg->RTCCR, CTL_START);
+}
+
+uint32_t rtc_getTime(void)
+{
+    return pReg->RTCDR;
+}
+
+void rtc_setTime(uint32_t seconds)
+{
+    /* The counter is updated with the Load Register's value on the next clock edge */
+    pReg->RTCLR = seconds;
+}
+
+void rtc_setAlarm(uint32_t seconds)
+{
+    /*
+     * Clear a stale alarm first, otherwise the interrupt would be
+     * triggered immediately once unmasked.
+     */
+    HWREG_CLEAR_BITS(pReg->RTCIMSC, INT_MATCH);
+    pReg->RTCICR = INT_MATCH;
+
+    /* the match is compared on equality, so wrapping around is fine */
+    pReg->RTCMR = pReg->RTCDR + seconds;
+
+    HWREG_SET_BITS(pReg->RTCIMSC, INT_MATCH);
+}
+
+void rtc_cancelAlarm(void)
+{
+    HWREG_CLEAR_BITS(pReg->RTCIMSC, INT_MATCH);
+    pReg->RTCICR = INT_MATCH;
+}
+
+int8_t rtc_isAlarmPending(void)
+{
+    return (HWREG_READ_BITS(pReg->RTCMIS, INT_MATCH) != 0);
+}
+
+void rtc_clearInterrupt(void)
+{
+    /*
+     * The register is write only, zero-bits have no effect,
+     * so the bitmask is simply written into it.
+     */
+    pReg->RTCICR = INT_MATCH;
+}
+
+uint32_t rtc_getEntropySample(void)
+{
+    /* the Data Register is the only register that changes on its own */
+    return pReg->RTCDR;
+}
@@ -0,0 +1,63 @@
+#ifndef _RTC_H_
+#define _RTC_H_
+
+#include <stdint.h>
+
+/**
+ * Initializes the real time clock controller.
+ * The counter is started (if not running yet), the match interrupt
+ * is disabled and a pending interrupt is cleared.
+ */
+void rtc_init(void);
+
+/**
+ * Returns the current value of the RTC's counter,
+ * i.e. the wall clock time in seconds.
+ *
+ * @return current time in seconds
+ */
+uint32_t rtc_getTime(void);
+
+/**
+ * Sets the current wall clock time.
+ *
+ * @param seconds - value to be loaded into the counter
+ */
+void rtc_setTime(uint32_t seconds);
+
+/**
+ * Arms the match interrupt to be triggered 'seconds' from now.
+ * The interrupt is enabled by this function, a previously pending
+ * alarm is cleared.
+ *
+ * @param seconds - number of seconds until the alarm (must be nonzero)
+ */
+void rtc_setAlarm(uint32_t seconds);
+
+/**
+ * Disables the match interrupt and clears a pending alarm.
+ */
+void rtc_cancelAlarm(void);
+
+/**
+ * Checks whether the armed alarm has expired.
+ *
+ * @return 0 if no alarm is pending, a nonzero value (typically 1) otherwise
+ */
+int8_t rtc_isAlarmPending(void);
+
+/**
+ * Clears the match interrupt output, the alarm is not rearmed.
+ */
+void rtc_clearInterrupt(void);
+
+/**
+ * Returns a cheap sample of the clock to be used as an entropy input.
+ * The RTC only advances once per second, so the sample is weak
+ * and must be mixed with other sources.
+ *
+ * @return entropy sample
+ */
+uint32_t rtc_getEntropySample(void);
+
+#endif /* _RTC_H_ */
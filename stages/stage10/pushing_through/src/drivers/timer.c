@@ -7,6 +7,7 @@
 #include "regutil.h"
 
 #include "../auth.h"
+#include "../sections.h"
 
 /* Number of counters per timer: */
 #define NR_COUNTERS      ( 2 )
@@ -168,7 +169,7 @@ void timer_disableInterrupt(uint8_t timerNr, uint8_t counterNr)
     }
 }
 
-void timer_clearInterrupt(uint8_t timerNr, uint8_t counterNr)
+FAST_TEXT void timer_clearInterrupt(uint8_t timerNr, uint8_t counterNr)
 {
     /*
      * Writing anything (e.g. 0xFFFFFFFF, i.e. all ones) into the
@@ -8,6 +8,7 @@
 #include "regutil.h"
 
 #include "../auth.h"
+#include "../sections.h"
 
 /*
  * Bit masks for the Line Control Register (UARTLCR_H).
@@ -413,7 +414,7 @@ void uart_clearRxInterrupt(uint8_t nr)
     }
 }
 
-int uart_readChar(uint8_t nr, char* ch)
+FAST_TEXT int uart_readChar(uint8_t nr, char* ch)
 {
     /* sanity checks */
     if ((nr >= BSP_NR_UARTS) || (ch == NULL))
@@ -0,0 +1,216 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "watchdog.h"
+
+#include "bsp.h"
+#include "pic.h"
+#include "regutil.h"
+
+#include "../sections.h"
+#include "../utils/atomic.h"
+
+/*
+ * Bit masks for the Control Register (WdogControl).
+ *
+ * For description of each control register's bit, see chapter 3 of DDI0270:
+ *
+ *  31:2 reserved
+ *   1: RESEN (reset output enable)
+ *   0: INTEN (enables the counter and the interrupt output)
+ */
+#define CTL_RESEN           ( 0x00000002 )
+#define CTL_INTEN           ( 0x00000001 )
+
+/* Writing this value to the Lock Register enables write access to all other registers */
+#define LOCK_UNLOCK         ( 0x1ACCE551 )
+#define LOCK_LOCK           ( 0x00000000 )
+
+/* PrimeCell ID of the SP805 (PCellID0..3) */
+#define SP805_CELLID        { 0x0D, 0xF0, 0x05, 0xB1 }
+
+/*
+ * 32-bit registers of the watchdog controller,
+ * relative to the controller's base address:
+ * See chapter 3 of DDI0270.
+ */
+typedef struct _SP805_WATCHDOG_REGS
+{
+    uint32_t LOAD;                   /* Load Register, WdogLoad */
+    const uint32_t VALUE;            /* Value Register, WdogValue, read only */
+    uint32_t CONTROL;                /* Control Register, WdogControl */
+    uint32_t INTCLR;                 /* Interrupt Clear Register, WdogIntClr, write only */
+    const uint32_t RIS;              /* Raw Interrupt Status Register, WdogRIS, read only */
+    const uint32_t MIS;              /* Masked Interrupt Status Register, WdogMIS, read only */
+    const uint32_t Reserved1[762];   /* Reserved, should not be modified */
+    uint32_t LOCK;                   /* Lock Register, WdogLock */
+    const uint32_t Reserved2[191];   /* Reserved, should not be modified */
+    uint32_t ITCR;                   /* Integration Test Control Register */
+    uint32_t ITOP;                   /* Integration Test Output Set Register, write only */
+    const uint32_t Reserved3[54];    /* Reserved, should not be modified */
+    const uint32_t PERIPHID[4];      /* Watchdog Peripheral ID, read only */
+    const uint32_t CELLID[4];        /* PrimeCell ID, read only */
+} SP805_WATCHDOG_REGS;
+
+/*
+ * 32-bit status and system control registers, relative to the
+ * controller's base address. Only the registers needed for a board
+ * reset are mapped, see chapter 4 of the DUI0225D.
+ */
+typedef struct _VERSATILE_SYSCTL_REGS
+{
+    const uint32_t Unused1[8];       /* Unused, should not be modified */
+    uint32_t SYS_LOCK;               /* Lock Register */
+    const uint32_t Unused2[7];       /* Unused, should not be modified */
+    uint32_t SYS_RESETCTL;           /* Reset Control Register */
+} VERSATILE_SYSCTL_REGS;
+
+#define SYS_LOCK_UNLOCK     ( 0x0000A05F )
+#define SYS_RESET_LEVEL     ( 0x00000007 )
+#define SYS_RESET_TRIGGER   ( 0x00000105 )
+
+static volatile SP805_WATCHDOG_REGS* const pReg = (SP805_WATCHDOG_REGS*) (BSP_WATCHDOG_BASE_ADDRESS);
+static volatile VERSATILE_SYSCTL_REGS* const pSysReg = (VERSATILE_SYSCTL_REGS*) (BSP_SYSCTL_BASE_ADDRESS);
+
+/*
+ * State of the software emulation, used when no SP805 is present.
+ * The emulation follows the hardware: the first expiry raises the interrupt,
+ * the second expiry without a kick in between resets the board.
+ * The flags are updated by watchdog_tick() from the IRQ.
+ */
+static int8_t __present = 0;
+static volatile int8_t __running = 0;
+static volatile int8_t __expired = 0;
+static uint32_t __load = 0xFFFFFFFF;
+static volatile uint32_t __value = 0xFFFFFFFF;
+
+void watchdog_init(void)
+{
+    const uint8_t cell_id[] = SP805_CELLID;
+
+    __present = 1;
+    for (int i = 0; i < sizeof(cell_id); i++)
+    {
+        if ((pReg->CELLID[i] & 0xFF) != cell_id[i])
+        {
+            __present = 0;
+            break;
+        }
+    }
+
+    watchdog_stop();
+    watchdog_kick();
+}
+
+int8_t watchdog_isPresent(void)
+{
+    return __present;
+}
+
+void watchdog_setLoad(uint32_t value)
+{
+    __load = value;
+    __value = value;
+
+    if (__present != 0)
+    {
+        pReg->LOCK = LOCK_UNLOCK;
+        pReg->LOAD = value;
+        pReg->LOCK = LOCK_LOCK;
+    }
+}
+
+void watchdog_start(void)
+{
+    const atomic_state_t state = atomic_enter_critical();
+
+    __expired = 0;
+    __value = __load;
+    __running = 1;
+
+    atomic_exit_critical(state);
+
+    if (__present != 0)
+    {
+        pReg->LOCK = LOCK_UNLOCK;
+        HWREG_SET_BITS(pReg->CONTROL, (CTL_INTEN | CTL_RESEN));
+        pReg->LOCK = LOCK_LOCK;
+    }
+}
+
+void watchdog_stop(void)
+{
+    __running = 0;
+
+    if (__present != 0)
+    {
+        pReg->LOCK = LOCK_UNLOCK;
+        HWREG_CLEAR_BITS(pReg->CONTROL, (CTL_INTEN | CTL_RESEN));
+        pReg->LOCK = LOCK_LOCK;
+    }
+}
+
+void watchdog_kick(void)
+{
+    if (__present != 0)
+    {
+        /*
+         * Writing anything into the Interrupt Clear Register clears the
+         * interrupt output and reloads the counter from the Load Register.
+         */
+        pReg->LOCK = LOCK_UNLOCK;
+        pReg->INTCLR = 0xFFFFFFFF;
+        pReg->LOCK = LOCK_LOCK;
+    }
+    else
+    {
+        /* the tick must not expire the counter between the reload and the clear */
+        const atomic_state_t state = atomic_enter_critical();
+
+        __value = __load;
+
+        if (__expired != 0)
+        {
+            __expired = 0;
+            pic_clearSoftwareInterrupt(BSP_WATCHDOG_IRQ);
+        }
+
+        atomic_exit_critical(state);
+    }
+}
+
+FAST_TEXT void watchdog_tick(uint32_t cycles)
+{
+    if ((__present != 0) || (__running == 0))
+    {
+        return;
+    }
+
+    if (__value > cycles)
+    {
+        __value -= cycles;
+        return;
+    }
+
+    if (__expired != 0)
+    {
+        watchdog_resetBoard();
+    }
+
+    __expired = 1;
+    __value = __load;
+
+    pic_raiseSoftwareInterrupt(BSP_WATCHDOG_IRQ);
+}
+
+void watchdog_resetBoard(void)
+{
+    /* The Reset Control Register is write protected, unlock it first */
+    pSysReg->SYS_LOCK = SYS_LOCK_UNLOCK;
+    pSysReg->SYS_RESETCTL = (pSysReg->SYS_RESETCTL & ~SYS_RESET_LEVEL) | SYS_RESET_TRIGGER;
+
+    while (1)
+    {
+        /* wait for the reset to take effect */
+    }
+}
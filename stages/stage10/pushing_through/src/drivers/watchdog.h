@@ -0,0 +1,64 @@
+#ifndef _WATCHDOG_H_
+#define _WATCHDOG_H_
+
+#include <stdint.h>
+
+/**
+ * Initializes the watchdog controller: the counter is stopped and
+ * a pending interrupt is cleared.
+ *
+ * If the SP805 is not present (e.g. QEMU's versatilepb does not model it),
+ * the watchdog is emulated in software and must be driven by watchdog_tick().
+ * The emulation raises the same IRQ (BSP_WATCHDOG_IRQ) as the hardware does.
+ */
+void watchdog_init(void);
+
+/**
+ * Checks whether a genuine SP805 controller responds at BSP_WATCHDOG_BASE_ADDRESS.
+ *
+ * @return 0 if the watchdog is emulated, a nonzero value (typically 1) if the SP805 is present
+ */
+int8_t watchdog_isPresent(void);
+
+/**
+ * Sets the timeout, in WDOGCLK cycles, after which the pre-timeout interrupt is triggered.
+ * If the interrupt is still not cleared when the same timeout elapses again,
+ * the board is reset.
+ *
+ * @param value - number of WDOGCLK cycles per timeout
+ */
+void watchdog_setLoad(uint32_t value);
+
+/**
+ * Starts the watchdog counter with both the interrupt and the reset output enabled.
+ */
+void watchdog_start(void);
+
+/**
+ * Stops the watchdog counter.
+ */
+void watchdog_stop(void);
+
+/**
+ * Clears the pre-timeout interrupt and reloads the counter from the Load Register.
+ */
+void watchdog_kick(void);
+
+/**
+ * Advances the software emulation of the watchdog.
+ * Nothing is done if a genuine SP805 is present.
+ *
+ * It is supposed to be called from a periodic ISR.
+ *
+ * @param cycles - number of WDOGCLK cycles elapsed since the last call
+ */
+void watchdog_tick(uint32_t cycles);
+
+/**
+ * Resets the whole board immediately through the system controller.
+ *
+ * This function does not return.
+ */
+void watchdog_resetBoard(void);
+
+#endif /* _WATCHDOG_H_ */
@@ -3,16 +3,30 @@
 
 #include "auth.h"
 #include "resources.h"
+#include "sections.h"
 
 #include "drivers/bsp.h"
+#include "drivers/cpu.h"
 #include "drivers/pic.h"
 #include "drivers/uart.h"
 #include "drivers/timer.h"
+#include "drivers/rtc.h"
+#include "drivers/watchdog.h"
+#include "drivers/hash.h"
 #include "drivers/verifier.h"
 
 #include "utils/itoa.h"
 #include "utils/crc32c.h"
+#include "utils/atomic.h"
 #include "utils/crypto.h"
+#include "utils/profiler.h"
+#include "utils/heap.h"
+#include "utils/stack.h"
+#include "utils/scheduler.h"
+#include "utils/nonce_pool.h"
+#include "utils/entropy_pool.h"
+#include "utils/selftest.h"
+#include "utils/bench.h"
 #include "utils/circular_buffer.h"
 
 #include "message.gen.h"
@@ -22,9 +36,32 @@
 #define TICK_TIMER            ( 0 )
 #define TICK_TIMER_COUNTER    ( 0 )
 
+#define TICK_TIMER_LOAD       ( (CPU_CLOCK_HZ / TICK_RATE_HZ) * TICKS_PER_HUND )
+
+/* periodic interrupt that feeds the entropy pool (timer 1 counter 0 is left to the selftest and bench) */
+#define SAMPLE_TIMER          ( 1 )
+#define SAMPLE_TIMER_COUNTER  ( 1 )
+#define SAMPLE_TIMER_LOAD     ( CPU_CLOCK_HZ / ENTROPY_POOL_SAMPLE_HZ )
+
+/* free running counter whose value at ISR entry is the entropy pool's sample */
+#define JITTER_TIMER          ( 0 )
+#define JITTER_TIMER_COUNTER  ( 1 )
+
+/* the watchdog interrupt fires after one timeout, the board is reset after two */
+#define WATCHDOG_TIMEOUT_SEC  ( 10 )
+
 #define TIMEOUT (3000)
+#define SESSION_TIMEOUT_TICKS ( TIMEOUT / TICKS_PER_HUND )
+
+/* events of the session task */
+#define SESSION_EVENT_START   ( 0x00000001 )
+#define SESSION_EVENT_RX      ( 0x00000002 )
+
+/* events of the nonce pool task */
+#define POOL_EVENT_REFILL     ( 0x00000001 )
 
 #define HELLO_OPCODE (0xaa)
+#define PROFILE_DUMP_OPCODE (0x50)
 #define HMAC_SECRET "the last one..."
 #define HMAC_SECRET_SIZE (strlen(HMAC_SECRET))
 
@@ -58,9 +95,35 @@ typedef enum
     state_finish
 } state_t;
 
+typedef struct
+{
+    int8_t task;
+    state_t state;
+    uint32_t nonce;
+    uint8_t hmac[HMAC256_SIZE];     /* expected HMAC of the nonce */
+    size_t received;                /* bytes of the HMAC compared so far */
+    size_t discard;                 /* bytes left of a rejected HMAC, not taken as opcodes */
+} session_t;
+
 DEFINE_CIRCULAR_BUFFER(io, 1024);
 DEFINE_TICKS_COUNTER(timer);
 
+static session_t session = { .task = -1, .state = state_ready };
+
+/* lowest priority task, prepares nonces whenever the session is idle */
+static int8_t pool_task = -1;
+
+/* key schedule of HMAC_SECRET, prepared once at boot */
+static hmac256_key_t hmac_key;
+
+static const state_t* watched_state = NULL;
+
+/* set once the watchdog interrupt has fired and masked its line, until the next kick */
+static volatile int8_t watchdog_warned = 0;
+
+/* the free running counter sampled by the ISRs into the entropy pool */
+static const volatile uint32_t* jitter_value = NULL;
+
 void init(void)
 {
     irq_disableIrqMode();
@@ -83,22 +146,38 @@ void init(void)
     {
         uart_init(i);
     }
+
+    rtc_init();
+    watchdog_init();
+    hash_init();
 }
 
-static void uart_isr(void)
+FAST_TEXT static void uart_isr(void)
 {
     char ch = 0;
 
+    /* the arrival time of the bytes */
+    entropy_pool_add_sample(*jitter_value);
+
     while (uart_readChar(COM_UART, &ch) == 0)
     {
         circular_buf_put(GET_CIRCULAR_BUFFER(io), ch);
     }
+
+    scheduler_postFromIsr(session.task, SESSION_EVENT_RX);
 }
 
-static void timer_isr(void)
+FAST_TEXT static void timer_isr(void)
 {
     INCRESE_TICKS_COUNTER(timer);
 
+    scheduler_tick();
+    watchdog_tick(TICK_TIMER_LOAD);
+
+#ifdef CONFIG_PROFILER
+    profiler_sample(irq_getInterruptedAddr());
+#endif
+
     timer_clearInterrupt(TICK_TIMER, TICK_TIMER_COUNTER);
 }
 
@@ -121,9 +200,7 @@ void setup_timer(void)
     const uint8_t timer_irqs[BSP_NR_TIMERS] = BSP_TIMER_IRQS;
     const uint8_t irq = timer_irqs[TICK_TIMER];
 
-    uint32_t compare_match = (CPU_CLOCK_HZ / TICK_RATE_HZ) * TICKS_PER_HUND;
-
-    timer_setLoad(TICK_TIMER, TICK_TIMER_COUNTER, compare_match);
+    timer_setLoad(TICK_TIMER, TICK_TIMER_COUNTER, TICK_TIMER_LOAD);
     timer_enableInterrupt(TICK_TIMER, TICK_TIMER_COUNTER);
 
     pic_registerIrq(irq, &timer_isr, PIC_MAX_PRIORITY);
@@ -132,6 +209,33 @@ void setup_timer(void)
     timer_start(TICK_TIMER, TICK_TIMER_COUNTER);
 }
 
+FAST_TEXT static void sample_isr(void)
+{
+    /* the latency of this interrupt, measured on a counter it does not reload */
+    entropy_pool_add_sample(*jitter_value);
+
+    timer_clearInterrupt(SAMPLE_TIMER, SAMPLE_TIMER_COUNTER);
+}
+
+void setup_entropy_sampling(void)
+{
+    const uint8_t timer_irqs[BSP_NR_TIMERS] = BSP_TIMER_IRQS;
+    const uint8_t irq = timer_irqs[SAMPLE_TIMER];
+
+    /* runs freely over the full 32 bits, without an interrupt */
+    jitter_value = timer_getValueAddr(JITTER_TIMER, JITTER_TIMER_COUNTER);
+    timer_setLoad(JITTER_TIMER, JITTER_TIMER_COUNTER, 0xFFFFFFFF);
+    timer_start(JITTER_TIMER, JITTER_TIMER_COUNTER);
+
+    timer_setLoad(SAMPLE_TIMER, SAMPLE_TIMER_COUNTER, SAMPLE_TIMER_LOAD);
+    timer_enableInterrupt(SAMPLE_TIMER, SAMPLE_TIMER_COUNTER);
+
+    pic_registerIrq(irq, &sample_isr, 40);
+    pic_enableInterrupt(irq);
+
+    timer_start(SAMPLE_TIMER, SAMPLE_TIMER_COUNTER);
+}
+
 void print(const char* str)
 {
     if (str != NULL)
@@ -146,6 +250,67 @@ void print_num(uint32_t num, uint32_t base)
     print(my_itoa(num, tmp, base));
 }
 
+void print_memory_usage(void)
+{
+    size_t heap_current = 0;
+    size_t heap_peak = 0;
+    heap_get_usage(&heap_current, &heap_peak);
+
+    print("# stack: svc ");
+    print_num(stack_high_watermark(stack_svc), 10);
+    print("/");
+    print_num(stack_size(stack_svc), 10);
+    print(", irq ");
+    print_num(stack_high_watermark(stack_irq), 10);
+    print("/");
+    print_num(stack_size(stack_irq), 10);
+    print(" bytes\r\n");
+
+    print("# heap: current ");
+    print_num(heap_current, 10);
+    print(", peak ");
+    print_num(heap_peak, 10);
+    print("/");
+    print_num(heap_size(), 10);
+    print(" bytes\r\n");
+}
+
+static void watchdog_isr(void)
+{
+    /*
+     * The interrupt is not cleared on purpose, so the watchdog resets the board
+     * on the next expiry unless it is kicked meanwhile. Mask the line to let the
+     * rest of the system run, the next kick unmasks it.
+     */
+    pic_disableInterrupt(BSP_WATCHDOG_IRQ);
+    watchdog_warned = 1;
+
+    /* polled output at this priority, kept to one short line */
+    print("\r\n### WATCHDOG ");
+    print_num(*watched_state, 10);
+    print(" ###\r\n");
+}
+
+static void kick_watchdog(void)
+{
+    watchdog_kick();
+
+    /* the kick cleared the interrupt, warn again on the next timeout */
+    if (watchdog_warned)
+    {
+        watchdog_warned = 0;
+        pic_enableInterrupt(BSP_WATCHDOG_IRQ);
+    }
+}
+
+void setup_watchdog(void)
+{
+    watchdog_setLoad(CPU_CLOCK_HZ * WATCHDOG_TIMEOUT_SEC);
+
+    pic_registerIrq(BSP_WATCHDOG_IRQ, &watchdog_isr, PIC_MAX_PRIORITY - 1);
+    pic_enableInterrupt(BSP_WATCHDOG_IRQ);
+}
+
 int check_drivers_auth(void)
 {
     volatile uint8_t* const PIC_SANITY = (uint8_t* const) PIC_AUTH_ADDR;
@@ -174,33 +339,6 @@ int check_drivers_auth(void)
     return 0;
 }
 
-ssize_t recv(uint8_t* buffer, size_t len, size_t timeout)
-{
-    /* sanity checks */
-    if ((buffer == NULL) || (len == 0))
-    {
-        return -1;
-    }
-
-    uint32_t s_ticks = GET_TICKS_COUNTER(timer);
-
-    size_t i = 0;
-    while (i < len)
-    {
-        if (circular_buf_get(GET_CIRCULAR_BUFFER(io), &(buffer[i])) == 0)
-        {
-            i++;
-            s_ticks = GET_TICKS_COUNTER(timer);
-        }
-        else if ((GET_TICKS_COUNTER(timer) - s_ticks) >= (timeout / TICKS_PER_HUND))
-        {
-            break;
-        }
-    }
-
-    return i;
-}
-
 ssize_t send(const uint8_t* buffer, size_t len)
 {
     if (buffer == NULL || (len == 0))
@@ -222,145 +360,155 @@ uint32_t little_to_big_endian(uint32_t value)
            ((value & 0xff0000) >> 8) | ((value & 0xff000000) >> 24);
 }
 
-ssize_t handle_ready_state(state_t* state, uint32_t* nonce)
+/*
+ * The UART ISR may overwrite the oldest byte (and so move the tail) at any time,
+ * so the buffer is only read with interrupts masked.
+ */
+static int get_byte(uint8_t* byte)
 {
-    /* sanity checks */
-    if ((state == NULL) || (nonce == NULL))
-    {
-        return -1;
-    }
+    const atomic_state_t state = atomic_enter_critical();
+    const int ret = circular_buf_get(GET_CIRCULAR_BUFFER(io), byte);
+    atomic_exit_critical(state);
 
-    print("> Waiting for `HELLO` opcode ... ");
+    return ret;
+}
+
+ssize_t enter_state(state_t state);
 
-    uint8_t opcode = 0;
-    if (recv(&opcode, sizeof(opcode), TIMEOUT) == sizeof(opcode))
+ssize_t handle_ready_state(uint8_t opcode)
+{
+    if (opcode == HELLO_OPCODE)
     {
-        if (opcode == HELLO_OPCODE)
+        print("[RECEIVED]\r\n");
+
+        /* a prepared nonce leaves nothing to compute, otherwise fall back to doing it now */
+        const int pooled = (nonce_pool_take(&session.nonce, session.hmac, sizeof(session.hmac)) == 0);
+
+        int ret = pooled ? 0 : rand((uint8_t*)&session.nonce, sizeof(session.nonce));
+        if (ret != 0)
+        {
+            PRINT_MBEDTLS_ERR(ret);
+            return -1;
+        }
+
+        uint32_t nonce_be = little_to_big_endian(session.nonce);
+
+        /*
+         * The nonce goes out first: it fits into the UART's FIFO, so the expected HMAC
+         * and the console output below are done while it is still on the wire, and
+         * before the peer could possibly answer.
+         */
+        if (send((uint8_t*)&nonce_be, sizeof(nonce_be)) != sizeof(nonce_be))
         {
-            print("[RECEIVED]\r\n");
+            return -1;
+        }
 
-            int ret = rand((uint8_t*)nonce, sizeof(*nonce));
+        if (!pooled)
+        {
+            ret = hmac256_with_key(&hmac_key, (const uint8_t*)&session.nonce, sizeof(session.nonce),
+                                   session.hmac, sizeof(session.hmac));
             if (ret != 0)
             {
                 PRINT_MBEDTLS_ERR(ret);
                 return -1;
             }
+        }
 
-            char buff[32] = { 0x00 };
-            my_itoa(*nonce, buff, 16);
-
-            print("> Sending NONCE (0x");
-            print(buff);
-            print(") ");
-
-            for (int i = strlen(buff); i < 8; i++)
-            {
-                print(".");
-            }
-
-            print("... [SENT]\r\n");
+        /* replaced once the session is idle again */
+        scheduler_post(pool_task, POOL_EVENT_REFILL);
 
-            uint32_t nonce_be = little_to_big_endian(*nonce);
+        char buff[32] = { 0x00 };
+        my_itoa(session.nonce, buff, 16);
 
-            if (send((uint8_t*)&nonce_be, sizeof(nonce_be)) != sizeof(nonce_be))
-            {
-                return -1;
-            }
+        print("> Sending NONCE (0x");
+        print(buff);
+        print(") ");
 
-            *state = state_hmac;
-        }
-        else
+        for (int i = strlen(buff); i < 8; i++)
         {
-            print("[RECEIVED INVALID OPCODE (0x");
-            print_num(opcode, 16);
-            print(")]\r\n");
+            print(".");
         }
+
+        print("... [SENT]\r\n");
+
+        return enter_state(state_hmac);
     }
+#ifdef CONFIG_PROFILER
+    else if (opcode == PROFILE_DUMP_OPCODE)
+    {
+        print("[PROFILE]\r\n");
+        profiler_dump(&print);
+        print_memory_usage();
+    }
+#endif
     else
     {
-        print("[TIMEOUT]\r\n");
+        print("[RECEIVED INVALID OPCODE (0x");
+        print_num(opcode, 16);
+        print(")]\r\n");
     }
 
-    return 0;
+    return enter_state(state_ready);
 }
 
-ssize_t handle_hmac_state(state_t* state, uint32_t* nonce)
+ssize_t handle_hmac_state(uint8_t byte)
 {
-    /* sanity checks */
-    if ((state == NULL) || (nonce == NULL))
+    /*
+     * Each byte is compared as soon as it arrives and the first mismatch rejects the HMAC.
+     * The position of the mismatch is of no use to the peer, the next HELLO gets a new nonce.
+     */
+    if (byte != session.hmac[session.received++])
     {
-        return -1;
-    }
-
-    print("> Waiting for HMAC256 .......... ");
+        session.discard = sizeof(session.hmac) - session.received;
 
-    uint8_t hmac[HMAC256_SIZE] = { 0x00 };
-    int ret = hmac256((const uint8_t*)HMAC_SECRET, HMAC_SECRET_SIZE, (const uint8_t*)nonce, sizeof(*nonce), hmac, sizeof(hmac));
-    if (ret != 0)
-    {
-        PRINT_MBEDTLS_ERR(ret);
-        return -1;
+        print("[RECEIVED INVALID HMAC]\r\n");
+        return enter_state(state_ready);
     }
 
-    uint8_t received_hmac[HMAC256_SIZE] = { 0x00 };
-    if (recv(received_hmac, sizeof(received_hmac), TIMEOUT) != sizeof(received_hmac))
+    if (session.received < sizeof(session.hmac))
     {
-        print("[TIMEOUT]\r\n");
+        /* the timeout applies to the gap between two bytes */
+        scheduler_setTimeout(session.task, SESSION_TIMEOUT_TICKS);
         return 0;
     }
 
-    if (memcmp(hmac, received_hmac, sizeof(hmac)) == 0)
-    {
-        print("[RECEIVED]\r\n");
-        *state = state_finish;
-    }
-    else
-    {
-        print("[RECEIVED INVALID HMAC]\r\n");
-        *state = state_ready;
-    }
-
-    return 0;
+    print("[RECEIVED]\r\n");
+    return enter_state(state_finish);
 }
 
-ssize_t handle_finish_state(state_t* state)
+ssize_t handle_finish_state(void)
 {
-    /* sanity checks */
-    if (state == NULL)
-    {
-        return -1;
-    }
-
     print("your secret is: \"");
     print(PLAIN_MESSAGE);
     print("\".\r\n");
 
-    *state = state_ready;
-
-    return 0;
+    return enter_state(state_ready);
 }
 
-ssize_t handle_state(state_t* state, uint32_t* nonce)
+ssize_t enter_state(state_t state)
 {
-    /* sanity checks */
-    if ((state == NULL) || (nonce == NULL))
-    {
-        return -1;
-    }
+    session.state = state;
 
-    switch (*state)
+    switch (state)
     {
         case (state_ready):
         {
-            return handle_ready_state(state, nonce);
+            print("> Waiting for `HELLO` opcode ... ");
+            break;
         }
         case (state_hmac):
         {
-            return handle_hmac_state(state, nonce);
+            /* the expected HMAC was computed right after the nonce was sent */
+            print("> Waiting for HMAC256 .......... ");
+
+            session.received = 0;
+            break;
         }
         case (state_finish):
         {
-            return handle_finish_state(state);
+            /* nothing to wait for */
+            scheduler_setTimeout(session.task, 0);
+            return handle_finish_state();
         }
         default:
         {
@@ -368,7 +516,96 @@ ssize_t handle_state(state_t* state, uint32_t* nonce)
         }
     }
 
-    return -1;
+    scheduler_setTimeout(session.task, SESSION_TIMEOUT_TICKS);
+
+    return 0;
+}
+
+int session_handler(uint32_t events)
+{
+    ssize_t ret = 0;
+    uint8_t received = 0;
+
+    if (events & SESSION_EVENT_START)
+    {
+        ret = enter_state(state_ready);
+    }
+
+    if (events & SESSION_EVENT_RX)
+    {
+        uint8_t byte = 0;
+
+        /* consume everything available, the state may change after every byte */
+        while ((ret == 0) && (get_byte(&byte) == 0))
+        {
+            received = 1;
+
+            switch (session.state)
+            {
+                case (state_ready):
+                {
+                    if (session.discard > 0)
+                    {
+                        /* the rest of a rejected HMAC */
+                        session.discard--;
+                        break;
+                    }
+
+                    ret = handle_ready_state(byte);
+                    break;
+                }
+                case (state_hmac):
+                {
+                    ret = handle_hmac_state(byte);
+                    break;
+                }
+                default:
+                {
+                    ret = -1;
+                    break;
+                }
+            }
+        }
+    }
+
+    /* a byte that arrived together with the timeout restarted the wait */
+    if ((ret == 0) && (events & SCHEDULER_EVENT_TIMEOUT) && !received)
+    {
+        print("[TIMEOUT]\r\n");
+
+        /* a peer that stopped halfway through a rejected HMAC is not waited for */
+        session.discard = 0;
+
+        /* wait again in the same state, an HMAC is still expected for the nonce already sent */
+        ret = enter_state(session.state);
+    }
+
+    if (ret == 0)
+    {
+        kick_watchdog();
+    }
+
+    return ret;
+}
+
+int pool_handler(uint32_t events)
+{
+    (void) events;
+
+    const int ret = nonce_pool_refill();
+    if (ret < 0)
+    {
+        PRINT_MBEDTLS_ERR(ret);
+        return ret;
+    }
+
+    /* a single entry per run, so pending session events are handled in between */
+    if (ret > 0)
+    {
+        scheduler_post(pool_task, POOL_EVENT_REFILL);
+    }
+
+    return 0;
 }
 
 int main(void)
@@ -376,8 +613,24 @@ int main(void)
     INIT_CIRCULAR_BUFFER(io);
     INIT_TICKS_COUNTER(timer);
 
+    /* all mbedTLS allocations are served from the static arena */
+    heap_init();
+
+    /* filled by the ISRs from now on, the random generator is seeded from it */
+    entropy_pool_init();
+
+#ifdef CONFIG_PROFILER
+    profiler_init();
+#endif
+
+    scheduler_init();
+    session.task = scheduler_addTask(&session_handler);
+    pool_task = scheduler_addTask(&pool_handler);
+
+    setup_entropy_sampling();
     setup_uart();
     setup_timer();
+    setup_watchdog();
 
     irq_enableIrqMode();
 
@@ -391,6 +644,33 @@ int main(void)
         return -1;
     }
 
+    /* seed the random generator once, nonces are cheap afterwards */
+    if (crypto_init() != 0)
+    {
+        return -1;
+    }
+
+    if (hmac256_key_init(&hmac_key, (const uint8_t*)HMAC_SECRET, HMAC_SECRET_SIZE) != 0)
+    {
+        return -1;
+    }
+
+    nonce_pool_init(&hmac_key);
+
+#ifdef CONFIG_SELFTEST
+    if (selftest_run(&print) != 0)
+    {
+        return -1;
+    }
+#endif
+
+#ifdef CONFIG_BENCH
+    if (bench_run(&print) != 0)
+    {
+        return -1;
+    }
+#endif
+
     print(BANNER);
     print("\r\n           = pushing through =            \r\n\r\n");
 
@@ -398,20 +678,23 @@ int main(void)
     print(HMAC_SECRET);
     print("\"\r\n\r\n");
 
-    state_t state = state_ready;
-    uint32_t nonce = 0;
+    watched_state = &session.state;
+    watchdog_start();
+
+    scheduler_post(session.task, SESSION_EVENT_START);
+    scheduler_post(pool_task, POOL_EVENT_REFILL);
+
+    int ret = scheduler_run();
+
+    print("### PANIC (");
+    print_num(-ret, 10);
+    print(")!! ###\r\n");
+    print_memory_usage();
 
     while (1)
     {
-        ssize_t ret = handle_state(&state, &nonce);
-        if (ret != 0)
-        {
-            print("### PANIC (");
-            print_num(-ret, 10);
-            print(")!! ###");
-
-            while (1) {}; /* infinity loop */
-        }
+        /* idle until the watchdog resets the board */
+        cpu_waitForInterrupt();
     }
 
     return 0;
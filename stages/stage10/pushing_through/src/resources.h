@@ -11,7 +11,7 @@
 #define INIT_CIRCULAR_BUFFER(name) circular_buf_init(&__res_cbuf_##name##_cbuf, __res_cbuf_##name##_buf, sizeof(__res_cbuf_##name##_buf))
 
 #define DEFINE_TICKS_COUNTER(name)\
-    uint32_t __res_ticks_##name##_counter = 0
+    volatile uint32_t __res_ticks_##name##_counter = 0
 
 #define GET_TICKS_COUNTER(name) (__res_ticks_##name##_counter)
 #define INIT_TICKS_COUNTER(name)\
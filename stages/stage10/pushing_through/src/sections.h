@@ -0,0 +1,13 @@
+#ifndef _SECTIONS_H_
+#define _SECTIONS_H_
+
+/*
+ * Places a function into the ".fast" output section (see dev/ldscript.ld).
+ *
+ * It is meant for the interrupt path and the short loops it calls: grouped
+ * together and aligned to cache lines, the whole set stays resident in the
+ * I-cache once the MMU and caches are enabled.
+ */
+#define FAST_TEXT __attribute__((section(".fast")))
+
+#endif /* _SECTIONS_H_ */
@@ -14,6 +14,10 @@
 
 .equ VECTORS_TABLE_ADDR, 0x00000000
 
+.equ PIC_INTENCLEAR_ADDR, 0x10140014  @ Primary Interrupt Controller's VICINTENCLEAR
+
+.equ STACK_PAINT_PATTERN, 0xDEADBEEF  @ must match STACK_PAINT_PATTERN in utils/stack.h
+
 .section .init
 .code 32
 
@@ -53,24 +57,43 @@ reset_handler:
     @ set "Supervisor" Mode stack
     LDR sp, =stack_top
 
+.ifndef CONFIG_HIGH_VECTORS
     @ copy vector table to address 0
     LDR r0, =vectors_start
-    LDR r1, =vectors_end
-    LDR r2, =#VECTORS_TABLE_ADDR
-vect_copy_loop:
-    LDRB r3, [r0], #1
-    STRB r3, [r2], #1
+    LDR r1, =#VECTORS_TABLE_ADDR
+    LDR r2, =vectors_end
+    BL copy_words
+.endif
+
+    @ initialize .data from its load address, unless it is linked to run in place
+    LDR r0, __data_load_addr
+    LDR r1, __data_begin_addr
+    LDR r2, __data_end_addr
+    SUB r2, r2, r1
+    ADD r2, r0, r2
     CMP r0, r1
-    BLO vect_copy_loop
+    BLNE copy_words
 
     @ clear the whole BSS section to zeros
     LDR r0, __bss_begin_addr
     LDR r1, __bss_end_addr
     MOV r2, #0
-bss_clear_loop:
-    CMP r0, r1
-    STRLTB r2, [r0], #1
-    BLT bss_clear_loop
+    BL fill_words
+
+    @ paint both stacks, so their high watermarks can be found later (see utils/stack.h)
+    LDR r0, =stack_bottom
+    LDR r1, =stack_top
+    LDR r2, =#STACK_PAINT_PATTERN
+    BL fill_words
+    LDR r0, =irq_stack_bottom
+    LDR r1, =irq_stack_top
+    BL fill_words
+
+.ifdef CONFIG_MMU
+    @ flat translation table, MMU, caches and write buffer (the table lives in BSS)
+    @ with CONFIG_HIGH_VECTORS, the vector table is mapped to 0xFFFF0000 too
+    BL cpu_enableMmu
+.endif
 
     @ get "Program Status Register" (CPSR)
     MRS r0, cpsr
@@ -100,11 +123,66 @@ bss_clear_loop:
     BL init
 
     @ jump to main
-    B main
+    BL main
 
-unhandled:
-    B .
+    @ main is not supposed to return, idle forever (interrupts are still serviced)
+    MOV r0, #0
+halt_loop:
+    MCR p15, 0, r0, c7, c0, 4       @ wait for interrupt
+    B halt_loop
 
+unhandled:
+    @ nothing to recover, disable all interrupt request lines and idle forever
+    LDR r0, =PIC_INTENCLEAR_ADDR
+    MVN r1, #0
+    STR r1, [r0]
+    MOV r0, #0
+unhandled_loop:
+    MCR p15, 0, r0, c7, c0, 4       @ wait for interrupt
+    B unhandled_loop
+
+@ fills words of [r0, r1) with r2, eight words per iteration
+@ the address must be word aligned, clobbers r0, r3-r9 and ip
+fill_words:
+    MOV r3, r2
+    MOV r4, r2
+    MOV r5, r2
+    MOV r6, r2
+    MOV r7, r2
+    MOV r8, r2
+    MOV r9, r2
+fill_words_loop:
+    ADD ip, r0, #32
+    CMP ip, r1
+    STMLSIA r0!, {r2-r9}
+    BLS fill_words_loop
+fill_words_tail:
+    CMP r0, r1
+    STRLO r2, [r0], #4
+    BLO fill_words_tail
+    BX lr
+
+@ copies words from [r0, r2) to r1, eight words per iteration
+@ both addresses must be word aligned, clobbers r0, r1, r3-r10 and ip
+copy_words:
+    ADD ip, r0, #32
+    CMP ip, r2
+    LDMLSIA r0!, {r3-r10}
+    STMLSIA r1!, {r3-r10}
+    BLS copy_words
+copy_words_tail:
+    CMP r0, r2
+    LDRLO r3, [r0], #4
+    STRLO r3, [r1], #4
+    BLO copy_words_tail
+    BX lr
+
+__data_load_addr:
+    .word __data_load
+__data_begin_addr:
+    .word __data_begin
+__data_end_addr:
+    .word __data_end
 __bss_begin_addr:
     .word __bss_begin
 __bss_end_addr:
@@ -0,0 +1,116 @@
+#ifndef _ATOMIC_H_
+#define _ATOMIC_H_
+
+#include <stdint.h>
+
+/*
+ * Building blocks for data shared between ISRs and thread context.
+ *
+ * ARMv5TE has no LDREX/STREX, so read-modify-write sequences are made atomic
+ * either by masking interrupts for their duration or, for a single word flag,
+ * by the SWP instruction.
+ */
+
+/* CPSR IRQ and FIQ disable bits */
+#define ATOMIC_IRQ_FIQ_BITS     ( 0x000000C0 )
+
+/**
+ * Saved interrupt state, returned by atomic_enter_critical().
+ */
+typedef uint32_t atomic_state_t;
+
+/**
+ * Prevents the compiler from reordering memory accesses across this point.
+ * No instruction is emitted.
+ */
+static inline void compiler_barrier(void)
+{
+    __asm volatile("" : : : "memory");
+}
+
+/**
+ * Prevents both the compiler and the core from reordering memory accesses
+ * across this point: all preceding writes have left the write buffer on return,
+ * see the "Drain write buffer" operation (c7, c10, 4) in chapter 2 of the DDI0222.
+ */
+static inline void memory_barrier(void)
+{
+    __asm volatile("MCR p15, 0, %0, c7, c10, 4" : : "r" (0) : "memory");
+}
+
+/**
+ * Masks IRQ and FIQ exceptions and returns the previous interrupt state.
+ *
+ * Critical sections may be nested: only the outermost atomic_exit_critical()
+ * enables the interrupts again, and only if they were enabled on entry.
+ * It is therefore safe to be called from ISRs as well.
+ *
+ * @return state to be passed to the matching atomic_exit_critical()
+ */
+static inline atomic_state_t atomic_enter_critical(void)
+{
+    atomic_state_t state;
+    uint32_t tmp;
+
+    __asm volatile("MRS %0, cpsr\n"
+                   "ORR %1, %0, %2\n"
+                   "MSR cpsr_c, %1"
+                   : "=&r" (state), "=&r" (tmp)
+                   : "I" (ATOMIC_IRQ_FIQ_BITS)
+                   : "memory");
+
+    return state;
+}
+
+/**
+ * Restores the interrupt state saved by the matching atomic_enter_critical().
+ *
+ * @param state - value returned by atomic_enter_critical()
+ */
+static inline void atomic_exit_critical(atomic_state_t state)
+{
+    uint32_t tmp;
+
+    /* only the I and F bits are restored, the mode is left untouched */
+    __asm volatile("MRS %0, cpsr\n"
+                   "BIC %0, %0, %2\n"
+                   "AND %1, %1, %2\n"
+                   "ORR %0, %0, %1\n"
+                   "MSR cpsr_c, %0"
+                   : "=&r" (tmp), "+r" (state)
+                   : "I" (ATOMIC_IRQ_FIQ_BITS)
+                   : "memory");
+}
+
+/**
+ * Atomically sets the flag to a nonzero value and returns its previous value.
+ * Uses SWP, so it is atomic against interrupts without masking them.
+ *
+ * @param flag - word aligned flag
+ * @return 0 if the flag was clear (i.e. it has been acquired), nonzero otherwise
+ */
+static inline uint32_t atomic_test_and_set(volatile uint32_t* flag)
+{
+    uint32_t old;
+
+    __asm volatile("SWP %0, %2, [%1]"
+                   : "=&r" (old)
+                   : "r" (flag), "r" (1)
+                   : "memory");
+
+    return old;
+}
+
+/**
+ * Clears a flag set by atomic_test_and_set(). All preceding memory
+ * accesses are completed (as seen by the compiler) before the flag is cleared.
+ *
+ * @param flag - word aligned flag
+ */
+static inline void atomic_clear(volatile uint32_t* flag)
+{
+    compiler_barrier();
+    *flag = 0;
+}
+
+#endif /* _ATOMIC_H_ */
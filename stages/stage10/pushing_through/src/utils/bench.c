@@ -0,0 +1,197 @@
+#ifdef CONFIG_BENCH
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "bench.h"
+
+#include "itoa.h"
+#include "crc32c.h"
+#include "crypto.h"
+
+#include "../drivers/hash.h"
+#include "../drivers/timer.h"
+
+/* arbitrary key, as long as the one of the session */
+#define BENCH_KEY       "0123456789abcdef"
+
+typedef int (*bench_func_t)(size_t size);
+
+typedef struct
+{
+    const char* name;
+    bench_func_t func;
+    size_t size;
+    uint32_t iterations;    /* enough for about a million instructions per case */
+    int8_t accel;           /* hashes on the SHA-256 accelerator, only run if it is present */
+} bench_case_t;
+
+static uint8_t __input[BENCH_MAX_SIZE];
+static uint8_t __output[BENCH_MAX_SIZE];
+static hmac256_key_t __key;
+
+/* largest value with the given number of decimal digits */
+static const uint32_t itoa_values[] =
+{
+    0, 9, 99, 999, 9999, 99999, 999999, 9999999, 99999999, 999999999, 0xFFFFFFFF
+};
+
+static int run_sha256(size_t size)
+{
+    return sha256(__input, size, __output, SHA256_SIZE);
+}
+
+static int run_hmac256(size_t size)
+{
+    return hmac256((const uint8_t*)BENCH_KEY, sizeof(BENCH_KEY) - 1, __input, size, __output, HMAC256_SIZE);
+}
+
+static int run_hmac256_with_key(size_t size)
+{
+    return hmac256_with_key(&__key, __input, size, __output, HMAC256_SIZE);
+}
+
+static int run_rand(size_t size)
+{
+    return rand(__output, size);
+}
+
+static int run_crc32c(size_t size)
+{
+    /* keeps the result alive */
+    __output[0] = (uint8_t)crc32c(0, __input, size);
+    return 0;
+}
+
+static int run_itoa(size_t size)
+{
+    return (my_itoa(itoa_values[size], (char*)__output, 10) != NULL) ? 0 : -1;
+}
+
+/*
+ * The hashing cases run in software first, whatever the machine, so that changes
+ * to the block function or the mbedTLS configuration show up. The "_accel" cases
+ * time the same calls on the accelerator, which QEMU completes without executing
+ * guest instructions: they measure the driver and the HMAC glue only.
+ */
+static const bench_case_t cases[] =
+{
+    { "sha256",                 &run_sha256,           16,   1024,  0 },
+    { "sha256",                 &run_sha256,           64,   512,   0 },
+    { "sha256",                 &run_sha256,           256,  256,   0 },
+    { "sha256",                 &run_sha256,           1024, 64,    0 },
+    { "hmac256",                &run_hmac256,          16,   256,   0 },
+    { "hmac256",                &run_hmac256,          64,   256,   0 },
+    { "hmac256",                &run_hmac256,          256,  128,   0 },
+    { "hmac256",                &run_hmac256,          1024, 64,    0 },
+    { "hmac256_with_key",       &run_hmac256_with_key, 4,    512,   0 },
+    { "hmac256_with_key",       &run_hmac256_with_key, 64,   512,   0 },
+    { "hmac256_with_key",       &run_hmac256_with_key, 1024, 64,    0 },
+    { "sha256_accel",           &run_sha256,           16,   1024,  1 },
+    { "sha256_accel",           &run_sha256,           1024, 1024,  1 },
+    { "hmac256_accel",          &run_hmac256,          16,   1024,  1 },
+    { "hmac256_with_key_accel", &run_hmac256_with_key, 4,    1024,  1 },
+    { "rand",                   &run_rand,             4,    64,    0 },
+    { "rand",                   &run_rand,             32,   64,    0 },
+    { "rand",                   &run_rand,             256,  32,    0 },
+    { "crc32c",                 &run_crc32c,           4,    16384, 0 },
+    { "crc32c",                 &run_crc32c,           64,   4096,  0 },
+    { "crc32c",                 &run_crc32c,           256,  1024,  0 },
+    { "crc32c",                 &run_crc32c,           1024, 256,   0 },
+    { "my_itoa",                &run_itoa,             1,    4096,  0 },
+    { "my_itoa",                &run_itoa,             5,    2048,  0 },
+    { "my_itoa",                &run_itoa,             10,   2048,  0 }
+};
+
+/* xorshift32, deterministic input so that runs can be compared */
+static void fill_input(void)
+{
+    uint32_t seed = 0x2545f491;
+
+    for (size_t i = 0; i < sizeof(__input); i += 4)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+
+        memcpy(&__input[i], &seed, sizeof(seed));
+    }
+}
+
+/*
+ * Runs a case and stores the ticks it took into 'ticks'.
+ *
+ * @return 0 if every call succeeded, -1 otherwise
+ */
+static int time_case(const bench_case_t* bench, uint32_t* ticks)
+{
+    int ret = 0;
+
+    /* the counter counts down */
+    const uint32_t start = timer_getValue(BENCH_TIMER, BENCH_TIMER_COUNTER);
+
+    for (uint32_t i = 0; i < bench->iterations; i++)
+    {
+        ret |= bench->func(bench->size);
+    }
+
+    *ticks = start - timer_getValue(BENCH_TIMER, BENCH_TIMER_COUNTER);
+
+    return (ret == 0) ? 0 : -1;
+}
+
+int bench_run(bench_print_t print)
+{
+    char tmp[32] = { 0x00 };
+    int ret = 0;
+
+    fill_input();
+
+    if (hmac256_key_init(&__key, (const uint8_t*)BENCH_KEY, sizeof(BENCH_KEY) - 1) != 0)
+    {
+        return -1;
+    }
+
+    timer_setLoad(BENCH_TIMER, BENCH_TIMER_COUNTER, 0xFFFFFFFF);
+    timer_start(BENCH_TIMER, BENCH_TIMER_COUNTER);
+
+    print("# bench: begin\r\n");
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        uint32_t ticks = 0;
+
+        if (cases[i].accel && !hash_isPresent())
+        {
+            continue;
+        }
+
+        hash_setEnabled(cases[i].accel);
+
+        const int failed = (time_case(&cases[i], &ticks) != 0);
+        if (failed)
+        {
+            ret = -1;
+        }
+
+        print(cases[i].name);
+        print(" ");
+        print(my_itoa(cases[i].size, tmp, 10));
+        print(" ");
+        print(my_itoa(cases[i].iterations, tmp, 10));
+        print(" ");
+        print(failed ? "FAILED" : my_itoa(ticks, tmp, 10));
+        print("\r\n");
+    }
+
+    hash_setEnabled(1);
+
+    print("# bench: done\r\n");
+
+    timer_stop(BENCH_TIMER, BENCH_TIMER_COUNTER);
+
+    return ret;
+}
+
+#endif /* CONFIG_BENCH */
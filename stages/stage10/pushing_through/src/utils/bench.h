@@ -0,0 +1,40 @@
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stdint.h>
+
+/* Largest input (and output) of a benchmark case, in bytes */
+#define BENCH_MAX_SIZE          ( 1024 )
+
+/* Free running counter the cases are timed with (the tick uses timer 0) */
+#define BENCH_TIMER             ( 1 )
+#define BENCH_TIMER_COUNTER     ( 0 )
+
+/**
+ * Required prototype of the routine that emits the results, line by line.
+ */
+typedef void (*bench_print_t)(const char* str);
+
+/**
+ * Times sha256(), hmac256(), hmac256_with_key(), rand(), crc32c() and my_itoa()
+ * over a matrix of input sizes. Each case calls the primitive a fixed number of
+ * times and is timed as a whole in ticks of the SP804 counter (us), interrupts
+ * included. The hashing is timed in software and, if the SHA-256 accelerator
+ * is present, on the accelerator as well ("_accel" cases).
+ *
+ * The results are emitted as a table meant for dev/bench.py:
+ *
+ *   # bench: begin
+ *   <name> <size> <iterations> <ticks>
+ *   <name> <size> <iterations> FAILED
+ *   ...
+ *   # bench: done
+ *
+ * For my_itoa() the size is the number of decimal digits of the converted value.
+ *
+ * @param print - routine used to output the results
+ * @return 0 if every call succeeded, -1 otherwise (the table is complete either way)
+ */
+int bench_run(bench_print_t print);
+
+#endif /* _BENCH_H_ */
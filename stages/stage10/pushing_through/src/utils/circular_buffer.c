@@ -4,7 +4,9 @@
 
 #include "circular_buffer.h"
 
-static inline size_t advance_headtail_value(size_t value, size_t max)
+#include "../sections.h"
+
+FAST_TEXT static inline size_t advance_headtail_value(size_t value, size_t max)
 {
     if (++value == max)
     {
@@ -14,7 +16,7 @@ static inline size_t advance_headtail_value(size_t value, size_t max)
     return value;
 }
 
-static inline void advance_head_pointer(cbuf_handle_t handle)
+FAST_TEXT static inline void advance_head_pointer(cbuf_handle_t handle)
 {
     if (circular_buf_full(handle))
     {
@@ -40,7 +42,7 @@ void circular_buf_reset(cbuf_handle_t handle)
     handle->full = false;
 }
 
-inline size_t circular_buf_size(cbuf_handle_t handle)
+FAST_TEXT inline size_t circular_buf_size(cbuf_handle_t handle)
 {
     size_t size = handle->max;
 
@@ -64,14 +66,14 @@ inline size_t circular_buf_capacity(cbuf_handle_t handle)
     return handle->max;
 }
 
-inline void circular_buf_put(cbuf_handle_t handle, uint8_t data)
+FAST_TEXT inline void circular_buf_put(cbuf_handle_t handle, uint8_t data)
 {
     handle->buffer[handle->head] = data;
 
     advance_head_pointer(handle);
 }
 
-inline int circular_buf_try_put(cbuf_handle_t handle, uint8_t data)
+FAST_TEXT inline int circular_buf_try_put(cbuf_handle_t handle, uint8_t data)
 {
     int r = -1;
 
@@ -85,7 +87,7 @@ inline int circular_buf_try_put(cbuf_handle_t handle, uint8_t data)
     return r;
 }
 
-int circular_buf_get(cbuf_handle_t handle, uint8_t* data)
+FAST_TEXT int circular_buf_get(cbuf_handle_t handle, uint8_t* data)
 {
     int r = -1;
 
@@ -101,12 +103,12 @@ int circular_buf_get(cbuf_handle_t handle, uint8_t* data)
     return r;
 }
 
-inline bool circular_buf_empty(cbuf_handle_t handle)
+FAST_TEXT inline bool circular_buf_empty(cbuf_handle_t handle)
 {
     return (!circular_buf_full(handle) && (handle->head == handle->tail));
 }
 
-inline bool circular_buf_full(cbuf_handle_t handle)
+FAST_TEXT inline bool circular_buf_full(cbuf_handle_t handle)
 {
     return handle->full;
 }
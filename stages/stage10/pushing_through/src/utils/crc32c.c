@@ -25,8 +25,24 @@
  *
  */
 
+#include <stdint.h>
+
 #include "crc32c.h"
 
+#include "../sections.h"
+
+#ifdef CONFIG_CRC32C_SLICE8
+
+/*
+ * Eight tables of the slicing-by-8 algorithm, generated at build time by
+ * dev/generate_crc32c_tables.py. The first one is the byte table below.
+ */
+#include "crc32c_tables.gen.h"
+
+#define crc32c_table        ( crc32c_tables[0] )
+
+#else
+
 /*
  * This is the CRC-32C table
  * Generated with:
@@ -103,12 +119,117 @@ static const uint32_t crc32c_table[256] = {
     0xBE2DA0A5L, 0x4C4623A6L, 0x5F16D052L, 0xAD7D5351L
 };
 
+#endif /* CONFIG_CRC32C_SLICE8 */
+
+#ifdef CONFIG_CRC32C_SLICE8
 
-uint32_t crc32c(uint32_t crc, const uint8_t *data, unsigned int length)
+/*
+ * Folds 8 bytes at once: the two words, XORed with the CRC, are looked up byte
+ * by byte in the table that accounts for the bytes still following each one.
+ * The words are read as a pair from an aligned address (a single LDM).
+ */
+static inline uint32_t crc32c_slice8(uint32_t crc, const uint32_t* words, unsigned int count)
 {
+    while (count--) {
+        const uint32_t lo = words[0] ^ crc;
+        const uint32_t hi = words[1];
+        words += 2;
+
+        crc = crc32c_tables[7][lo & 0xFF] ^
+              crc32c_tables[6][(lo >> 8) & 0xFF] ^
+              crc32c_tables[5][(lo >> 16) & 0xFF] ^
+              crc32c_tables[4][lo >> 24] ^
+              crc32c_tables[3][hi & 0xFF] ^
+              crc32c_tables[2][(hi >> 8) & 0xFF] ^
+              crc32c_tables[1][(hi >> 16) & 0xFF] ^
+              crc32c_tables[0][hi >> 24];
+    }
+
+    return crc;
+}
+
+#endif /* CONFIG_CRC32C_SLICE8 */
+
+FAST_TEXT uint32_t crc32c_update(uint32_t crc, const uint8_t *data, unsigned int length)
+{
+#ifdef CONFIG_CRC32C_SLICE8
+    /* bytewise up to a word boundary, the core (little endian) handles 8 bytes per step */
+    while ((length != 0) && (((uintptr_t)data & 3) != 0)) {
+        crc = crc32c_table[(crc ^ *data++) & 0xFFL] ^ (crc >> 8);
+        length--;
+    }
+
+    crc = crc32c_slice8(crc, (const uint32_t*)data, length / 8);
+    data += length & ~7U;
+    length &= 7;
+#endif
+
     while (length--) {
         crc = crc32c_table[(crc ^ *data++) & 0xFFL] ^ (crc >> 8);
     }
-    return crc^0xffffffff;
+    return crc;
+}
+
+FAST_TEXT uint32_t crc32c(uint32_t crc, const uint8_t *data, unsigned int length)
+{
+    return crc32c_final(crc32c_update(crc, data, length));
+}
+
+/* product of a 32x32 GF(2) matrix (one column per bit) and a vector */
+static uint32_t gf2_matrix_times(const uint32_t *mat, uint32_t vec)
+{
+    uint32_t sum = 0;
+
+    while (vec) {
+        if (vec & 1)
+            sum ^= *mat;
+        vec >>= 1;
+        mat++;
+    }
+    return sum;
+}
+
+static void gf2_matrix_square(uint32_t *square, const uint32_t *mat)
+{
+    for (int n = 0; n < 32; n++)
+        square[n] = gf2_matrix_times(mat, mat[n]);
+}
+
+uint32_t crc32c_combine(uint32_t crc_a, uint32_t crc_b, uint32_t len_b)
+{
+    uint32_t even[32];      /* even power of two zero bytes operator */
+    uint32_t odd[32];       /* odd power of two zero bytes operator */
+
+    if (len_b == 0)
+        return crc_a;
+
+    /* operator for one zero bit */
+    odd[0] = CRC32C_POLY;
+    for (int n = 1; n < 32; n++)
+        odd[n] = 1UL << (n - 1);
+
+    gf2_matrix_square(even, odd);   /* two zero bits */
+    gf2_matrix_square(odd, even);   /* four zero bits */
+
+    /*
+     * Appending len_b zero bytes to A is applying the one zero byte operator
+     * len_b times: square it for each bit of len_b and apply it where the bit
+     * is set. The pre and post inversions of both CRCs cancel out.
+     */
+    do {
+        gf2_matrix_square(even, odd);
+        if (len_b & 1)
+            crc_a = gf2_matrix_times(even, crc_a);
+        len_b >>= 1;
+        if (len_b == 0)
+            break;
+
+        gf2_matrix_square(odd, even);
+        if (len_b & 1)
+            crc_a = gf2_matrix_times(odd, crc_a);
+        len_b >>= 1;
+    } while (len_b != 0);
+
+    return crc_a ^ crc_b;
 }
 
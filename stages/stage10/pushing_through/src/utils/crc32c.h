@@ -30,6 +30,51 @@
 
 #include <stdint.h>
 
+/* Reflected polynomial */
+#define CRC32C_POLY     ( 0x82F63B78UL )
+
+/*
+ * Checksum of a single buffer. The register starts from 'crc' as is and
+ * the result is inverted, so only a 'crc' of 0xFFFFFFFF gives the standard
+ * CRC32C (and results of this function cannot be chained).
+ */
 uint32_t crc32c(uint32_t crc, const uint8_t *data, unsigned int length);
 
+/*
+ * Incremental checksum, across any number of buffers:
+ *
+ *   uint32_t crc = crc32c_init();
+ *   crc = crc32c_update(crc, first, first_len);
+ *   crc = crc32c_update(crc, second, second_len);
+ *   crc = crc32c_final(crc);
+ */
+static inline uint32_t crc32c_init(void)
+{
+    return 0xFFFFFFFF;
+}
+
+/*
+ * Feeds 'length' bytes of 'data' to a running checksum.
+ *
+ * @param crc - running checksum, from crc32c_init() or a previous update
+ * @return the updated running checksum
+ */
+uint32_t crc32c_update(uint32_t crc, const uint8_t *data, unsigned int length);
+
+static inline uint32_t crc32c_final(uint32_t crc)
+{
+    return crc ^ 0xFFFFFFFF;
+}
+
+/*
+ * Checksum of the concatenation A || B from the final checksums of A and B,
+ * without going over the data again. The cost is logarithmic in 'len_b'.
+ *
+ * @param crc_a - final checksum of A
+ * @param crc_b - final checksum of B
+ * @param len_b - length of B in bytes
+ * @return final checksum of A || B
+ */
+uint32_t crc32c_combine(uint32_t crc_a, uint32_t crc_b, uint32_t len_b);
+
 #endif /* _CRC32C_H_ */
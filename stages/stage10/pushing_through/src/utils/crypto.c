@@ -1,203 +1,251 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <mbedtls/md.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/platform_util.h>
 #include <mbedtls/entropy.h>
 #include <mbedtls/hmac_drbg.h>
 
 #include "crypto.h"
+#include "entropy_pool.h"
 
-static int entropy_seed(void* data, unsigned char* output, size_t len, size_t* olen)
-{
-    (void) data;
+#include "../drivers/hash.h"
 
-    volatile uint32_t* const RTC = (uint32_t* const)0x101e8000;
+/* the DRBG is instantiated once by crypto_init() and lives until reset */
+static mbedtls_hmac_drbg_context __drbg;
+static mbedtls_entropy_context __entropy;
+static uint8_t __drbgReady;
 
-    int retval = 0;
+int crypto_init(void)
+{
+    if (__drbgReady)
+    {
+        return 0;
+    }
 
-    mbedtls_md_context_t ctx = {};
-    const mbedtls_md_info_t* md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA512);
+    const mbedtls_md_info_t* md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
 
-    mbedtls_md_init(&ctx);
+    mbedtls_hmac_drbg_init(&__drbg);
+    mbedtls_entropy_init(&__entropy);
 
-    int ret = mbedtls_md_setup(&ctx, md_info, 0);
+    /* the interrupt timing jitter collected by the ISRs, see entropy_pool.h */
+    int ret = mbedtls_entropy_add_source(&__entropy, &entropy_pool_read, NULL, SHA256_SIZE, MBEDTLS_ENTROPY_SOURCE_STRONG);
     if (ret != 0)
     {
-        retval = ret;
         goto cleanup;
     }
 
-    ret = mbedtls_md_starts(&ctx);
+    ret = mbedtls_hmac_drbg_seed(&__drbg, md_info, mbedtls_entropy_func, &__entropy, (const unsigned char *) "RANDOM_GEN", 10);
     if (ret != 0)
     {
-        retval = ret;
         goto cleanup;
     }
 
-    ret = mbedtls_md_update(&ctx, (const uint8_t*)RTC, sizeof(*RTC));
-    if (ret != 0)
-    {
-        retval = ret;
-        goto cleanup;
-    }
+    mbedtls_hmac_drbg_set_reseed_interval(&__drbg, CRYPTO_RAND_RESEED_INTERVAL);
+    mbedtls_hmac_drbg_set_prediction_resistance(&__drbg, CRYPTO_RAND_PREDICTION_RESISTANCE ?
+                                                MBEDTLS_HMAC_DRBG_PR_ON : MBEDTLS_HMAC_DRBG_PR_OFF);
 
-    ret = mbedtls_md_finish(&ctx, output);
-    if (ret != 0)
-    {
-        retval = ret;
-        goto cleanup;
-    }
+    __drbgReady = 1;
 
-    *olen = mbedtls_md_get_size(md_info);
+    return 0;
 
 cleanup:
-    mbedtls_md_free(&ctx);
+    mbedtls_hmac_drbg_free(&__drbg);
+    mbedtls_entropy_free(&__entropy);
 
-    return retval;
+    return ret;
 }
 
 int rand(uint8_t* output, size_t len)
 {
     /* sanity checks */
-    if ((output == NULL) || (len == 0))
+    if ((output == NULL) || (len == 0) || !__drbgReady)
     {
         return -1;
     }
 
-    int retval = 0;
+    /* reseeds from the entropy source on its own, as configured in crypto_init() */
+    return mbedtls_hmac_drbg_random(&__drbg, output, len);
+}
 
-    const mbedtls_md_info_t* md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
-    mbedtls_hmac_drbg_context hmac_drbg = {};
-    mbedtls_entropy_context entropy = {};
+#define HMAC_IPAD (0x36)
+#define HMAC_OPAD (0x5c)
 
-    mbedtls_hmac_drbg_init(&hmac_drbg);
-    mbedtls_entropy_init(&entropy);
+int hmac256_key_init(hmac256_key_t* hkey, const uint8_t* key, size_t klen)
+{
+    /* sanity checks */
+    if ((hkey == NULL) || (key == NULL) || (klen == 0))
+    {
+        return -1;
+    }
 
-    int ret = mbedtls_entropy_add_source(&entropy, &entropy_seed, NULL, MBEDTLS_ENTROPY_BLOCK_SIZE, MBEDTLS_ENTROPY_SOURCE_STRONG);
+    uint8_t block[SHA256_BLOCK_SIZE] = { 0x00 };
+
+    mbedtls_sha256_init(&hkey->inner);
+    mbedtls_sha256_init(&hkey->outer);
+
+    int ret = 0;
+
+    /* keys longer than a block are hashed first, shorter ones are zero padded */
+    if (klen > sizeof(block))
+    {
+        ret = mbedtls_sha256(key, klen, block, 0);
+        if (ret != 0)
+        {
+            goto cleanup;
+        }
+    }
+    else
+    {
+        memcpy(block, key, klen);
+    }
+
+    for (size_t i = 0; i < sizeof(block); i++)
+    {
+        block[i] ^= HMAC_IPAD;
+    }
+
+    ret = mbedtls_sha256_starts(&hkey->inner, 0);
     if (ret != 0)
     {
-        retval = ret;
         goto cleanup;
     }
 
-    ret = mbedtls_hmac_drbg_seed(&hmac_drbg, md_info, mbedtls_entropy_func, &entropy, (const unsigned char *) "RANDOM_GEN", 10);
+    ret = mbedtls_sha256_update(&hkey->inner, block, sizeof(block));
     if (ret != 0)
     {
-        retval = ret;
         goto cleanup;
     }
 
-    mbedtls_hmac_drbg_set_prediction_resistance(&hmac_drbg, MBEDTLS_HMAC_DRBG_PR_OFF);
+    memcpy(hkey->ipad, block, sizeof(block));
+
+    /* turn the inner pad into the outer one */
+    for (size_t i = 0; i < sizeof(block); i++)
+    {
+        block[i] ^= HMAC_IPAD ^ HMAC_OPAD;
+    }
+
+    memcpy(hkey->opad, block, sizeof(block));
 
-    ret = mbedtls_hmac_drbg_random(&hmac_drbg, output, len);
+    ret = mbedtls_sha256_starts(&hkey->outer, 0);
     if (ret != 0)
     {
-        retval = ret;
         goto cleanup;
     }
 
+    ret = mbedtls_sha256_update(&hkey->outer, block, sizeof(block));
+
 cleanup:
-    mbedtls_hmac_drbg_free(&hmac_drbg);
-    mbedtls_entropy_free(&entropy);
+    mbedtls_platform_zeroize(block, sizeof(block));
+
+    if (ret != 0)
+    {
+        mbedtls_sha256_free(&hkey->inner);
+        mbedtls_sha256_free(&hkey->outer);
+        mbedtls_platform_zeroize(hkey->ipad, sizeof(hkey->ipad));
+        mbedtls_platform_zeroize(hkey->opad, sizeof(hkey->opad));
+    }
 
-    return retval;
+    return ret;
 }
 
-int hmac256(const uint8_t* key, size_t klen, const uint8_t* msg, size_t len, uint8_t* output, size_t olen)
+int hmac256_with_key(const hmac256_key_t* hkey, const uint8_t* msg, size_t len, uint8_t* output, size_t olen)
 {
-    /* saniy checks */
-    if ((key == NULL) || (klen == 0) || (msg == NULL) || (len == 0) || (output == NULL) || (olen != HMAC256_SIZE))
+    /* sanity checks */
+    if ((hkey == NULL) || (msg == NULL) || (len == 0) || (output == NULL) || (olen != HMAC256_SIZE))
     {
         return -1;
     }
 
-    int retval = 0;
+    uint8_t inner_hash[SHA256_SIZE] = { 0x00 };
+    mbedtls_sha256_context ctx;
 
-    mbedtls_md_context_t ctx = {};
-    const mbedtls_md_info_t* md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
-
-    mbedtls_md_init(&ctx);
-
-    int ret = mbedtls_md_setup(&ctx, md_info, 1);
-    if (ret != 0)
+    /* H((K ^ opad) || H((K ^ ipad) || msg)), each hash in one go on the accelerator */
+    if (hash_isEnabled() &&
+        (hash_sha256(hkey->ipad, sizeof(hkey->ipad), msg, len, inner_hash) == 0) &&
+        (hash_sha256(hkey->opad, sizeof(hkey->opad), inner_hash, sizeof(inner_hash), output) == 0))
     {
-        retval = ret;
-        goto cleanup;
+        mbedtls_platform_zeroize(inner_hash, sizeof(inner_hash));
+        return 0;
     }
 
-    ret = mbedtls_md_hmac_starts(&ctx, key, klen);
+    mbedtls_sha256_init(&ctx);
+
+    /* H((K ^ ipad) || msg), resumed from the precomputed state */
+    mbedtls_sha256_clone(&ctx, &hkey->inner);
+
+    int ret = mbedtls_sha256_update(&ctx, msg, len);
     if (ret != 0)
     {
-        retval = ret;
         goto cleanup;
     }
 
-    ret = mbedtls_md_hmac_update(&ctx, msg, len);
+    ret = mbedtls_sha256_finish(&ctx, inner_hash);
     if (ret != 0)
     {
-        retval = ret;
         goto cleanup;
     }
 
-    ret = mbedtls_md_hmac_finish(&ctx, output);
+    /* H((K ^ opad) || inner hash) */
+    mbedtls_sha256_clone(&ctx, &hkey->outer);
+
+    ret = mbedtls_sha256_update(&ctx, inner_hash, sizeof(inner_hash));
     if (ret != 0)
     {
-        retval = ret;
         goto cleanup;
     }
 
+    ret = mbedtls_sha256_finish(&ctx, output);
+
 cleanup:
-    mbedtls_md_free(&ctx);
+    mbedtls_sha256_free(&ctx);
+    mbedtls_platform_zeroize(inner_hash, sizeof(inner_hash));
 
-    return retval;
+    return ret;
 }
 
-int sha256(const uint8_t* data, size_t len, uint8_t* output, size_t olen)
+int hmac256(const uint8_t* key, size_t klen, const uint8_t* msg, size_t len, uint8_t* output, size_t olen)
 {
     /* saniy checks */
-    if ((data == NULL) || (len == 0) || (output == NULL) || (olen != SHA256_SIZE))
+    if ((key == NULL) || (klen == 0) || (msg == NULL) || (len == 0) || (output == NULL) || (olen != HMAC256_SIZE))
     {
         return -1;
     }
 
-    int retval = 0;
-
-    mbedtls_md_context_t ctx = {};
-    mbedtls_md_type_t md_type = MBEDTLS_MD_SHA256;
-    const mbedtls_md_info_t* md_info = mbedtls_md_info_from_type(md_type);
-
-    mbedtls_md_init(&ctx);
+    /* a one-off key schedule on the stack, nothing is allocated */
+    hmac256_key_t hkey;
 
-    int ret = mbedtls_md_setup(&ctx, md_info, 0);
+    int ret = hmac256_key_init(&hkey, key, klen);
     if (ret != 0)
     {
-        retval = ret;
-        goto cleanup;
+        return ret;
     }
 
-    ret = mbedtls_md_starts(&ctx);
-    if (ret != 0)
-    {
-        retval = ret;
-        goto cleanup;
-    }
+    ret = hmac256_with_key(&hkey, msg, len, output, olen);
 
-    ret = mbedtls_md_update(&ctx, data, len);
-    if (ret != 0)
+    mbedtls_sha256_free(&hkey.inner);
+    mbedtls_sha256_free(&hkey.outer);
+    mbedtls_platform_zeroize(hkey.ipad, sizeof(hkey.ipad));
+    mbedtls_platform_zeroize(hkey.opad, sizeof(hkey.opad));
+
+    return ret;
+}
+
+int sha256(const uint8_t* data, size_t len, uint8_t* output, size_t olen)
+{
+    /* saniy checks */
+    if ((data == NULL) || (len == 0) || (output == NULL) || (olen != SHA256_SIZE))
     {
-        retval = ret;
-        goto cleanup;
+        return -1;
     }
 
-    ret = mbedtls_md_finish(&ctx, output);
-    if (ret != 0)
+    if (hash_isEnabled() && (hash_sha256(NULL, 0, data, len, output) == 0))
     {
-        retval = ret;
-        goto cleanup;
+        return 0;
     }
 
-cleanup:
-    mbedtls_md_free(&ctx);
-
-    return retval;
+    /* the context lives on the stack of mbedtls_sha256(), nothing is allocated */
+    return mbedtls_sha256(data, len, output, 0);
 }
@@ -4,18 +4,60 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <mbedtls/sha256.h>
+
 #define HMAC256_SIZE (32)
 #define SHA256_SIZE (32)
+#define SHA256_BLOCK_SIZE (64)
+
+/*
+ * Precomputed HMAC-SHA-256 key: the SHA-256 states right after hashing
+ * the inner (key ^ ipad) and the outer (key ^ opad) padded key blocks.
+ * The padded blocks themselves are kept for the hash accelerator, which
+ * cannot resume from a state.
+ */
+typedef struct
+{
+    mbedtls_sha256_context inner;
+    mbedtls_sha256_context outer;
+    uint8_t ipad[SHA256_BLOCK_SIZE];
+    uint8_t opad[SHA256_BLOCK_SIZE];
+} hmac256_key_t;
+
+/*
+ * Reseed policy of the random generator, may be overridden at build time:
+ * the DRBG reseeds from the entropy source after this many rand() calls,
+ * or before every call if prediction resistance is enabled (nonzero).
+ */
+#ifndef CRYPTO_RAND_RESEED_INTERVAL
+#define CRYPTO_RAND_RESEED_INTERVAL (1000)
+#endif
+
+#ifndef CRYPTO_RAND_PREDICTION_RESISTANCE
+#define CRYPTO_RAND_PREDICTION_RESISTANCE (0)
+#endif
+
+/**
+ * Instantiates the random generator (HMAC_DRBG over SHA-256) and seeds it
+ * from the entropy source. It is kept for all subsequent rand() calls.
+ *
+ * Must be called once at boot, after the heap and the entropy pool are initialized
+ * and with IRQs enabled: the first seed waits for enough interrupts to be sampled.
+ *
+ * @return 0 if successful, an mbedTLS error code otherwise.
+ */
+int crypto_init(void);
 
 /**
- * Generates a sequence of random bytes using a hardware random number generator.
+ * Generates a sequence of random bytes using the DRBG instantiated by crypto_init().
  *
  * @brief Generates random bytes.
  *
  * @param output Pointer to the buffer where the random bytes will be stored.
  * @param len    Number of random bytes to generate and store in the buffer.
  *
- * @return 0 if successful, -1 otherwise.
+ * @return 0 if successful, -1 if not initialized or on invalid arguments,
+ *         an mbedTLS error code otherwise.
  */
 int rand(uint8_t* output, size_t len);
 
@@ -36,17 +78,46 @@ int rand(uint8_t* output, size_t len);
 int hmac256(const uint8_t* key, size_t klen, const uint8_t* msg, size_t len, uint8_t* output, size_t olen);
 
 /**
- * Computes the HMAC-SHA-256 message authentication code for the provided key and message.
+ * Precomputes the key schedule of HMAC-SHA-256 for a key that is used for many messages.
  *
- * @brief Computes the HMAC-SHA-256.
+ * @brief Prepares an HMAC-SHA-256 key.
  *
- * @param key       Pointer to the key used to compute the HMAC-SHA-256.
+ * @param hkey      Pointer to the key schedule to be initialized.
+ * @param key       Pointer to the key.
  * @param klen      Length of the key in bytes.
+ *
+ * @return 0 if successful, -1 on invalid arguments, an mbedTLS error code otherwise.
+ */
+int hmac256_key_init(hmac256_key_t* hkey, const uint8_t* key, size_t klen);
+
+/**
+ * Computes the HMAC-SHA-256 of a message with a key prepared by hmac256_key_init().
+ * Only the message and the inner hash are compressed, the key pads are not hashed again.
+ * Both hashes are offloaded to the hash accelerator if it is present.
+ *
+ * @brief Computes the HMAC-SHA-256 with a precomputed key.
+ *
+ * @param hkey      Pointer to the prepared key schedule, it is not modified.
  * @param msg       Pointer to the message to authenticate.
  * @param len       Length of the message in bytes.
  * @param output    Pointer to the buffer where the computed HMAC-SHA-256 will be stored.
  * @param olen      Length of the output signature buffer in bytes.
  *
+ * @return 0 if successful, -1 on invalid arguments, an mbedTLS error code otherwise.
+ */
+int hmac256_with_key(const hmac256_key_t* hkey, const uint8_t* msg, size_t len, uint8_t* output, size_t olen);
+
+/**
+ * Computes the SHA-256 digest of the provided data, on the hash accelerator if it
+ * is present and in software otherwise (or if the accelerator fails).
+ *
+ * @brief Computes the SHA-256.
+ *
+ * @param data      Pointer to the data to be hashed.
+ * @param len       Length of the data in bytes.
+ * @param output    Pointer to the buffer where the computed digest will be stored.
+ * @param olen      Length of the output buffer in bytes.
+ *
  * @return 0 if successful, -1 otherwise.
  */
 int sha256(const uint8_t* data, size_t len, uint8_t* output, size_t olen);
@@ -0,0 +1,107 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <mbedtls/sha256.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/platform_util.h>
+
+#include "entropy_pool.h"
+#include "atomic.h"
+#include "crc32c.h"
+#include "crypto.h"
+
+#include "../drivers/cpu.h"
+#include "../drivers/rtc.h"
+
+#include "../sections.h"
+
+/*
+ * The samples are spread over the words in turn, each one mixed in with CRC32C.
+ * CRC32C does not lose what the samples carry (it is a bijection of a word for a
+ * given sample), the SHA-256 at read time does the actual conditioning.
+ */
+static volatile uint32_t __pool[ENTROPY_POOL_WORDS];
+static volatile uint32_t __samples;     /* samples mixed in since the last read */
+static volatile uint32_t __next;        /* word the next sample goes to */
+
+static uint32_t __reads;
+
+void entropy_pool_init(void)
+{
+    const atomic_state_t state = atomic_enter_critical();
+
+    for (size_t i = 0; i < ENTROPY_POOL_WORDS; i++)
+    {
+        __pool[i] = 0;
+    }
+
+    __samples = 0;
+    __next = 0;
+    __reads = 0;
+
+    /* differs from boot to boot, yet it is not credited */
+    entropy_pool_add_sample(rtc_getEntropySample());
+    __samples = 0;
+
+    atomic_exit_critical(state);
+}
+
+FAST_TEXT void entropy_pool_add_sample(uint32_t sample)
+{
+    const uint32_t i = __next;
+
+    __pool[i] = crc32c(__pool[i], (const uint8_t*)&sample, sizeof(sample));
+
+    __next = (i + 1) % ENTROPY_POOL_WORDS;
+    __samples++;
+}
+
+int entropy_pool_read(void* data, unsigned char* output, size_t len, size_t* olen)
+{
+    (void) data;
+
+    /* sanity checks */
+    if (len < SHA256_SIZE)
+    {
+        return MBEDTLS_ERR_ENTROPY_SOURCE_FAILED;
+    }
+
+    uint32_t snapshot[ENTROPY_POOL_WORDS + 1];
+
+    /* the same idiom as the scheduler: an IRQ arriving in between still ends the wait */
+    atomic_state_t state = atomic_enter_critical();
+
+    while (__samples < ENTROPY_POOL_MIN_SAMPLES)
+    {
+        cpu_waitForInterrupt();
+
+        atomic_exit_critical(state);
+        state = atomic_enter_critical();
+    }
+
+    for (size_t i = 0; i < ENTROPY_POOL_WORDS; i++)
+    {
+        snapshot[i] = __pool[i];
+    }
+
+    __samples -= ENTROPY_POOL_MIN_SAMPLES;
+
+    atomic_exit_critical(state);
+
+    /* two reads of a pool that has not changed in between still differ */
+    snapshot[ENTROPY_POOL_WORDS] = __reads++;
+
+    int ret = mbedtls_sha256((const uint8_t*)snapshot, sizeof(snapshot), output, 0);
+
+    mbedtls_platform_zeroize(snapshot, sizeof(snapshot));
+
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    *olen = SHA256_SIZE;
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef _ENTROPY_POOL_H_
+#define _ENTROPY_POOL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Number of 32-bit words the samples are spread over */
+#define ENTROPY_POOL_WORDS          ( 16 )
+
+/*
+ * Entropy credited to a sample, in bits. A sample is a free running counter
+ * read at ISR entry, only the jitter of the interrupt latency is unpredictable.
+ */
+#define ENTROPY_POOL_BITS_PER_SAMPLE    ( 1 )
+
+/*
+ * Number of fresh samples a single read of the pool requires. Each read is
+ * credited as SHA256_SIZE (32) bytes.
+ */
+#define ENTROPY_POOL_MIN_SAMPLES    ( (32 * 8) / ENTROPY_POOL_BITS_PER_SAMPLE )
+
+/*
+ * Rate of the periodic interrupt that samples the counter. A read waits for
+ * ENTROPY_POOL_MIN_SAMPLES / ENTROPY_POOL_SAMPLE_HZ, i.e. 128 ms, at most.
+ */
+#define ENTROPY_POOL_SAMPLE_HZ      ( 2000 )
+
+/**
+ * Initializes the pool, its first sample is the RTC's Data Register.
+ */
+void entropy_pool_init(void);
+
+/**
+ * Mixes a timing sample into the pool, i.e. the value of a free running
+ * counter read when an interrupt is served. The counter must not be
+ * reloaded by the interrupt it is sampled in.
+ *
+ * It is supposed to be called from ISRs only (IRQs masked).
+ *
+ * @param sample - the counter value
+ */
+void entropy_pool_add_sample(uint32_t sample);
+
+/**
+ * Entropy source callback for mbedtls_entropy_add_source(). Waits until enough
+ * fresh samples have been collected and condenses the pool with SHA-256.
+ *
+ * Must be called with IRQs enabled, otherwise it waits forever.
+ *
+ * @param data - unused
+ * @param output - where the entropy is stored
+ * @param len - length of the 'output' buffer, at least SHA256_SIZE
+ * @param olen - where the number of stored bytes is returned
+ *
+ * @return 0 if successful, MBEDTLS_ERR_ENTROPY_SOURCE_FAILED if 'len' is too small.
+ */
+int entropy_pool_read(void* data, unsigned char* output, size_t len, size_t* olen);
+
+#endif /* _ENTROPY_POOL_H_ */
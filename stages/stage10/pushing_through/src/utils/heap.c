@@ -0,0 +1,49 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <mbedtls/memory_buffer_alloc.h>
+
+#include "heap.h"
+
+/* boundaries of the heap region, provided by the linker script */
+extern uint8_t __heap_begin[];
+extern uint8_t __heap_end[];
+
+void heap_init(void)
+{
+    mbedtls_memory_buffer_alloc_init(__heap_begin, heap_size());
+}
+
+size_t heap_size(void)
+{
+    return __heap_end - __heap_begin;
+}
+
+void heap_get_usage(size_t* current, size_t* peak)
+{
+    size_t blocks = 0;
+
+    if (current != NULL)
+    {
+        mbedtls_memory_buffer_alloc_cur_get(current, &blocks);
+    }
+
+    if (peak != NULL)
+    {
+        mbedtls_memory_buffer_alloc_max_get(peak, &blocks);
+    }
+}
+
+/*
+ * newlib's malloc() would grow its heap from the linker's 'end' symbol right
+ * into the stacks. All allocations are supposed to go through the arena,
+ * so the system heap is disabled altogether.
+ */
+void* _sbrk(ptrdiff_t increment)
+{
+    (void) increment;
+
+    errno = ENOMEM;
+    return (void*) -1;
+}
@@ -0,0 +1,31 @@
+#ifndef _HEAP_H_
+#define _HEAP_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Hands the heap region reserved by the linker script (__heap_begin ... __heap_end)
+ * over to the mbedTLS buffer allocator. Every mbedtls_calloc()/mbedtls_free()
+ * is served from this static arena afterwards.
+ *
+ * Must be called once at boot, before any cryptographic operation.
+ */
+void heap_init(void);
+
+/**
+ * Returns the size of the arena.
+ *
+ * @return size of the heap region in bytes
+ */
+size_t heap_size(void);
+
+/**
+ * Reports the arena's usage, including the allocator's own block headers.
+ *
+ * @param current - bytes allocated right now (may be NULL)
+ * @param peak - most bytes allocated at once since heap_init() (may be NULL)
+ */
+void heap_get_usage(size_t* current, size_t* peak);
+
+#endif /* _HEAP_H_ */
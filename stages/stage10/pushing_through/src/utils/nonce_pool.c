@@ -0,0 +1,91 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <mbedtls/platform_util.h>
+
+#include "nonce_pool.h"
+
+typedef struct
+{
+    uint32_t nonce;
+    uint8_t hmac[HMAC256_SIZE];
+} nonce_entry_t;
+
+/*
+ * A ring of prepared entries. Only the tasks use it, they never preempt each
+ * other, so no critical sections are needed.
+ */
+static nonce_entry_t __entries[NONCE_POOL_SIZE];
+static size_t __head;
+static size_t __count;
+
+static const hmac256_key_t* __hkey;
+
+void nonce_pool_init(const hmac256_key_t* hkey)
+{
+    mbedtls_platform_zeroize(__entries, sizeof(__entries));
+
+    __head = 0;
+    __count = 0;
+    __hkey = hkey;
+}
+
+int nonce_pool_refill(void)
+{
+    /* sanity checks */
+    if (__hkey == NULL)
+    {
+        return -1;
+    }
+
+    if (__count >= NONCE_POOL_SIZE)
+    {
+        return 0;
+    }
+
+    nonce_entry_t* entry = &__entries[(__head + __count) % NONCE_POOL_SIZE];
+
+    int ret = rand((uint8_t*)&entry->nonce, sizeof(entry->nonce));
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    ret = hmac256_with_key(__hkey, (const uint8_t*)&entry->nonce, sizeof(entry->nonce),
+                           entry->hmac, sizeof(entry->hmac));
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    __count++;
+
+    return (__count < NONCE_POOL_SIZE) ? 1 : 0;
+}
+
+int nonce_pool_take(uint32_t* nonce, uint8_t* hmac, size_t olen)
+{
+    /* sanity checks */
+    if ((nonce == NULL) || (hmac == NULL) || (olen != HMAC256_SIZE) || (__count == 0))
+    {
+        return -1;
+    }
+
+    nonce_entry_t* entry = &__entries[__head];
+
+    *nonce = entry->nonce;
+    memcpy(hmac, entry->hmac, olen);
+
+    mbedtls_platform_zeroize(entry, sizeof(*entry));
+
+    __head = (__head + 1) % NONCE_POOL_SIZE;
+    __count--;
+
+    return 0;
+}
+
+size_t nonce_pool_count(void)
+{
+    return __count;
+}
@@ -0,0 +1,47 @@
+#ifndef _NONCE_POOL_H_
+#define _NONCE_POOL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crypto.h"
+
+/* Number of nonces prepared ahead of time */
+#ifndef NONCE_POOL_SIZE
+#define NONCE_POOL_SIZE (4)
+#endif
+
+/**
+ * Initializes an empty pool. Its entries are authenticated with 'hkey',
+ * which must stay valid as long as the pool is used.
+ *
+ * @param hkey - prepared HMAC key the expected HMACs are computed with
+ */
+void nonce_pool_init(const hmac256_key_t* hkey);
+
+/**
+ * Prepares a single entry: a random nonce and its expected HMAC.
+ * Meant to be called repeatedly from idle time, it does nothing once the pool is full.
+ *
+ * @return 1 if there is room for more entries, 0 if the pool is full,
+ *         -1 if not initialized, an mbedTLS error code otherwise.
+ */
+int nonce_pool_refill(void);
+
+/**
+ * Takes the oldest prepared entry out of the pool. Its slot is wiped.
+ *
+ * @param nonce - where the nonce is stored
+ * @param hmac - where the expected HMAC of the nonce is stored
+ * @param olen - length of the 'hmac' buffer, must be HMAC256_SIZE
+ *
+ * @return 0 if successful, -1 if the pool is empty or on invalid arguments.
+ */
+int nonce_pool_take(uint32_t* nonce, uint8_t* hmac, size_t olen);
+
+/**
+ * @return number of prepared entries
+ */
+size_t nonce_pool_count(void);
+
+#endif /* _NONCE_POOL_H_ */
@@ -0,0 +1,108 @@
+#ifdef CONFIG_PROFILER
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "profiler.h"
+
+#include "itoa.h"
+
+/* boundaries of the profiled code, provided by the linker script */
+extern const uint8_t __text_begin[];
+extern const uint8_t __text_end[];
+
+static volatile uint32_t __buckets[PROFILER_NR_BUCKETS];
+static volatile uint32_t __total;
+static volatile uint32_t __outside;
+
+static uint32_t __begin;
+static uint32_t __end;
+static uint8_t __shift;
+
+void profiler_init(void)
+{
+    __begin = (uint32_t) __text_begin;
+    __end = (uint32_t) __text_end;
+
+    /* the smallest power of two bucket width that covers the whole code range */
+    __shift = 2;
+    while (((__end - __begin) >> __shift) >= PROFILER_NR_BUCKETS)
+    {
+        __shift++;
+    }
+
+    profiler_reset();
+}
+
+void profiler_reset(void)
+{
+    for (size_t i = 0; i < PROFILER_NR_BUCKETS; i++)
+    {
+        __buckets[i] = 0;
+    }
+
+    __total = 0;
+    __outside = 0;
+}
+
+void profiler_sample(uint32_t pc)
+{
+    __total++;
+
+    if ((pc < __begin) || (pc >= __end))
+    {
+        __outside++;
+        return;
+    }
+
+    __buckets[(pc - __begin) >> __shift]++;
+}
+
+void profiler_dump(profiler_print_t print)
+{
+    char tmp[32] = { 0x00 };
+
+    /* sanity checks */
+    if (print == NULL)
+    {
+        return;
+    }
+
+    /*
+     * Take a snapshot of the counters first, so the header stays
+     * consistent with the buckets while the tick keeps sampling.
+     */
+    const uint32_t total = __total;
+    const uint32_t outside = __outside;
+
+    print("# profile: begin=0x");
+    print(my_itoa(__begin, tmp, 16));
+    print(" end=0x");
+    print(my_itoa(__end, tmp, 16));
+    print(" shift=");
+    print(my_itoa(__shift, tmp, 10));
+    print(" total=");
+    print(my_itoa(total, tmp, 10));
+    print(" outside=");
+    print(my_itoa(outside, tmp, 10));
+    print("\r\n");
+
+    for (size_t i = 0; i < PROFILER_NR_BUCKETS; i++)
+    {
+        const uint32_t samples = __buckets[i];
+        if (samples == 0)
+        {
+            continue;
+        }
+
+        print("0x");
+        print(my_itoa(__begin + (i << __shift), tmp, 16));
+        print(" ");
+        print(my_itoa(samples, tmp, 10));
+        print("\r\n");
+    }
+
+    print("# profile: done\r\n");
+}
+
+#endif /* CONFIG_PROFILER */
@@ -0,0 +1,52 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <stdint.h>
+
+/*
+ * Number of histogram buckets spread over the code range (__text_begin ... __text_end).
+ * The width of a bucket is the smallest power of two that lets the whole range fit.
+ */
+#define PROFILER_NR_BUCKETS (1024)
+
+/**
+ * Required prototype of the routine that emits the dump, line by line.
+ */
+typedef void (*profiler_print_t)(const char* str);
+
+/**
+ * Initializes the profiler: computes the bucket width for the linked code range
+ * and clears the histogram.
+ */
+void profiler_init(void);
+
+/**
+ * Clears all collected samples, the bucket layout is kept.
+ */
+void profiler_reset(void);
+
+/**
+ * Accounts a single sample to the bucket that covers 'pc'.
+ * Samples outside of the code range are counted separately as "outside".
+ *
+ * It is supposed to be called from the tick ISR only.
+ *
+ * @param pc - address of the interrupted instruction
+ */
+void profiler_sample(uint32_t pc);
+
+/**
+ * Emits the raw histogram in a line based, machine readable format:
+ *
+ *   # profile: begin=<hex> end=<hex> shift=<dec> total=<dec> outside=<dec>
+ *   <bucket address, hex> <samples, dec>
+ *   ...
+ *   # profile: done
+ *
+ * Only nonzero buckets are emitted. See dev/profile_symbolize.py for the host side.
+ *
+ * @param print - routine used to output each part of the dump
+ */
+void profiler_dump(profiler_print_t print);
+
+#endif /* _PROFILER_H_ */
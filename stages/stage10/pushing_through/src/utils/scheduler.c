@@ -0,0 +1,145 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "scheduler.h"
+#include "atomic.h"
+
+#include "../drivers/cpu.h"
+
+#include "../sections.h"
+
+typedef struct
+{
+    task_handler_t handler;
+    volatile uint32_t events;       /* pending events, set by ISRs and tasks */
+    volatile uint32_t timeout;      /* remaining ticks, 0 if not armed */
+} task_t;
+
+static task_t __tasks[SCHEDULER_MAX_TASKS];
+static uint8_t __nrTasks;
+
+static inline int8_t is_valid_task(int8_t task)
+{
+    return (task >= 0) && (task < __nrTasks);
+}
+
+void scheduler_init(void)
+{
+    for (size_t i = 0; i < SCHEDULER_MAX_TASKS; i++)
+    {
+        __tasks[i].handler = NULL;
+        __tasks[i].events = 0;
+        __tasks[i].timeout = 0;
+    }
+
+    __nrTasks = 0;
+}
+
+int8_t scheduler_addTask(task_handler_t handler)
+{
+    if ((handler == NULL) || (__nrTasks >= SCHEDULER_MAX_TASKS))
+    {
+        return -1;
+    }
+
+    __tasks[__nrTasks].handler = handler;
+
+    return __nrTasks++;
+}
+
+void scheduler_post(int8_t task, uint32_t events)
+{
+    const atomic_state_t state = atomic_enter_critical();
+    scheduler_postFromIsr(task, events);
+    atomic_exit_critical(state);
+}
+
+FAST_TEXT void scheduler_postFromIsr(int8_t task, uint32_t events)
+{
+    if (is_valid_task(task))
+    {
+        __tasks[task].events |= events;
+    }
+}
+
+void scheduler_setTimeout(int8_t task, uint32_t ticks)
+{
+    if (!is_valid_task(task))
+    {
+        return;
+    }
+
+    const atomic_state_t state = atomic_enter_critical();
+
+    __tasks[task].timeout = ticks;
+
+    /* a timeout that expired but was not handled yet is stale now */
+    __tasks[task].events &= ~SCHEDULER_EVENT_TIMEOUT;
+
+    atomic_exit_critical(state);
+}
+
+FAST_TEXT void scheduler_tick(void)
+{
+    for (uint8_t i = 0; i < __nrTasks; i++)
+    {
+        if ((__tasks[i].timeout != 0) && (--__tasks[i].timeout == 0))
+        {
+            __tasks[i].events |= SCHEDULER_EVENT_TIMEOUT;
+        }
+    }
+}
+
+/*
+ * Takes the pending events of the highest priority task that has any.
+ * Must be called with IRQs masked.
+ *
+ * @return id of the task, or -1 if no events are pending
+ */
+static int8_t take_events(uint32_t* events)
+{
+    for (uint8_t i = 0; i < __nrTasks; i++)
+    {
+        if (__tasks[i].events != 0)
+        {
+            *events = __tasks[i].events;
+            __tasks[i].events = 0;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+int scheduler_run(void)
+{
+    while (1)
+    {
+        uint32_t events = 0;
+
+        /*
+         * IRQs are masked while the queue is checked, so an event posted
+         * in between still wakes the core up from the wait below.
+         */
+        const atomic_state_t state = atomic_enter_critical();
+
+        const int8_t task = take_events(&events);
+        if (task < 0)
+        {
+            cpu_waitForInterrupt();
+        }
+
+        atomic_exit_critical(state);
+
+        if (task >= 0)
+        {
+            const int ret = __tasks[task].handler(events);
+            if (ret != 0)
+            {
+                return ret;
+            }
+        }
+    }
+
+    return 0;
+}
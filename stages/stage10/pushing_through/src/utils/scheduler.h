@@ -0,0 +1,80 @@
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include <stdint.h>
+
+/* Maximum number of tasks that can be added to the run queue */
+#define SCHEDULER_MAX_TASKS       ( 4 )
+
+/*
+ * Event posted by the scheduler itself once a task's timeout has expired.
+ * All other bits of the event mask are free to be defined by the tasks.
+ */
+#define SCHEDULER_EVENT_TIMEOUT   ( 0x80000000 )
+
+/**
+ * Required prototype of a task's handler.
+ *
+ * The handler is called with all events posted to the task since its previous
+ * run and must not block, i.e. it handles whatever is available and returns.
+ *
+ * @param events - mask of the pending events (never zero)
+ * @return 0 on success, a nonzero value stops the scheduler
+ */
+typedef int (*task_handler_t)(uint32_t events);
+
+/**
+ * Initializes the scheduler: the run queue is emptied.
+ */
+void scheduler_init(void);
+
+/**
+ * Appends a task to the run queue. Tasks added first have the higher
+ * priority, i.e. they are run first when several have pending events.
+ *
+ * @param handler - routine that handles the task's events
+ * @return id of the task, or -1 if the run queue is full
+ */
+int8_t scheduler_addTask(task_handler_t handler);
+
+/**
+ * Posts events to a task, safe to be called from any context.
+ *
+ * @param task - id of the task
+ * @param events - mask of events to be added to the task's pending events
+ */
+void scheduler_post(int8_t task, uint32_t events);
+
+/**
+ * Posts events to a task with IRQs already masked, e.g. from an ISR.
+ *
+ * @param task - id of the task
+ * @param events - mask of events to be added to the task's pending events
+ */
+void scheduler_postFromIsr(int8_t task, uint32_t events);
+
+/**
+ * Arms (or rearms) the task's timeout. Once the given number of ticks has
+ * elapsed, SCHEDULER_EVENT_TIMEOUT is posted to the task. It is a one-shot.
+ *
+ * @param task - id of the task
+ * @param ticks - number of ticks until the timeout, 0 cancels it
+ */
+void scheduler_setTimeout(int8_t task, uint32_t ticks);
+
+/**
+ * Advances the timeouts of all tasks by a single tick.
+ *
+ * It is supposed to be called from the tick ISR only.
+ */
+void scheduler_tick(void);
+
+/**
+ * Runs the tasks' handlers as long as there are pending events, in order of the
+ * tasks' priority. Once no events are pending, the core waits for an interrupt.
+ *
+ * @return the nonzero value returned by the handler that stopped the scheduler
+ */
+int scheduler_run(void);
+
+#endif /* _SCHEDULER_H_ */
@@ -0,0 +1,255 @@
+#ifdef CONFIG_SELFTEST
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "selftest.h"
+
+#include "itoa.h"
+#include "crypto.h"
+#include "sha256_arm.h"
+
+#include "../drivers/hash.h"
+#include "../drivers/timer.h"
+
+#define ROTR(x, n)  ( ((x) >> (n)) | ((x) << (32 - (n))) )
+
+typedef void (*block_func_t)(uint32_t state[8], const uint8_t block[64]);
+
+typedef struct
+{
+    const char* name;
+    const char* msg;
+    uint8_t digest[SHA256_SIZE];
+} kat_t;
+
+static const uint32_t K[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/* FIPS 180-4 initial hash value */
+static const uint32_t H0[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static const kat_t sha256_kats[] =
+{
+    {
+        "sha256 (one block)", "abc",
+        { 0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+          0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad }
+    },
+    {
+        "sha256 (two blocks)", "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        { 0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+          0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1 }
+    }
+};
+
+/* RFC 4231, test case 2 */
+static const kat_t hmac256_kat =
+{
+    "Jefe", "what do ya want for nothing?",
+    { 0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+      0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43 }
+};
+
+/*
+ * Straightforward C block function, the reference sha256_block_arm() is checked
+ * and timed against. It follows FIPS 180-4 6.2.2 literally.
+ */
+static void sha256_block_ref(uint32_t state[8], const uint8_t block[64])
+{
+    uint32_t w[64];
+    uint32_t v[8];
+
+    for (int t = 0; t < 16; t++)
+    {
+        w[t] = ((uint32_t)block[4 * t] << 24) | ((uint32_t)block[4 * t + 1] << 16) |
+               ((uint32_t)block[4 * t + 2] << 8) | (uint32_t)block[4 * t + 3];
+    }
+
+    for (int t = 16; t < 64; t++)
+    {
+        const uint32_t s0 = ROTR(w[t - 15], 7) ^ ROTR(w[t - 15], 18) ^ (w[t - 15] >> 3);
+        const uint32_t s1 = ROTR(w[t - 2], 17) ^ ROTR(w[t - 2], 19) ^ (w[t - 2] >> 10);
+        w[t] = s1 + w[t - 7] + s0 + w[t - 16];
+    }
+
+    memcpy(v, state, sizeof(v));
+
+    for (int t = 0; t < 64; t++)
+    {
+        const uint32_t t1 = v[7] + (ROTR(v[4], 6) ^ ROTR(v[4], 11) ^ ROTR(v[4], 25)) +
+                            ((v[4] & v[5]) ^ (~v[4] & v[6])) + K[t] + w[t];
+        const uint32_t t2 = (ROTR(v[0], 2) ^ ROTR(v[0], 13) ^ ROTR(v[0], 22)) +
+                            ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+
+        for (int i = 7; i > 0; i--)
+        {
+            v[i] = v[i - 1];
+        }
+
+        v[4] += t1;
+        v[0] = t1 + t2;
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        state[i] += v[i];
+    }
+}
+
+/* xorshift32, deterministic filler for the test blocks */
+static uint32_t next_random(uint32_t* seed)
+{
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+
+    return *seed;
+}
+
+static void fill_block(uint8_t block[64], uint32_t* seed)
+{
+    for (int i = 0; i < 64; i += 4)
+    {
+        const uint32_t value = next_random(seed);
+        memcpy(&block[i], &value, sizeof(value));
+    }
+}
+
+static int report(selftest_print_t print, const char* name, int passed)
+{
+    print("# selftest: ");
+    print(name);
+    print(passed ? " ... ok\r\n" : " ... FAILED\r\n");
+
+    return passed ? 0 : -1;
+}
+
+/*
+ * Runs the known answer tests with the accelerator disabled (sha256_block_arm
+ * through mbedTLS) or enabled.
+ */
+static int check_kats(selftest_print_t print, int8_t accel)
+{
+    uint8_t digest[SHA256_SIZE];
+    int ret = 0;
+
+    print(accel ? "# selftest: on the accelerator\r\n" : "# selftest: in software\r\n");
+    hash_setEnabled(accel);
+
+    for (size_t i = 0; i < sizeof(sha256_kats) / sizeof(sha256_kats[0]); i++)
+    {
+        const kat_t* kat = &sha256_kats[i];
+
+        const int passed = (sha256((const uint8_t*)kat->msg, strlen(kat->msg), digest, sizeof(digest)) == 0) &&
+                           (memcmp(digest, kat->digest, sizeof(digest)) == 0);
+
+        ret |= report(print, kat->name, passed);
+    }
+
+    const int passed = (hmac256((const uint8_t*)hmac256_kat.name, strlen(hmac256_kat.name),
+                                (const uint8_t*)hmac256_kat.msg, strlen(hmac256_kat.msg),
+                                digest, sizeof(digest)) == 0) &&
+                       (memcmp(digest, hmac256_kat.digest, sizeof(digest)) == 0);
+
+    ret |= report(print, "hmac256 (RFC 4231 #2)", passed);
+
+    hash_setEnabled(1);
+
+    return ret;
+}
+
+/* both block functions must agree, also on unaligned blocks */
+static int check_block_function(selftest_print_t print)
+{
+    uint8_t buffer[64 + 1];
+    uint32_t state_ref[8];
+    uint32_t state_arm[8];
+    uint32_t seed = 0x2545f491;
+
+    memcpy(state_ref, H0, sizeof(state_ref));
+    memcpy(state_arm, H0, sizeof(state_arm));
+
+    for (int i = 0; i < SELFTEST_BENCH_BLOCKS; i++)
+    {
+        uint8_t* const block = &buffer[i & 1];
+
+        fill_block(block, &seed);
+
+        sha256_block_ref(state_ref, block);
+        sha256_block_arm(state_arm, block);
+    }
+
+    return report(print, "sha256_block_arm vs C reference",
+                  memcmp(state_ref, state_arm, sizeof(state_ref)) == 0);
+}
+
+static uint32_t time_blocks(block_func_t func)
+{
+    uint8_t block[64];
+    uint32_t state[8];
+    uint32_t seed = 0x2545f491;
+
+    memcpy(state, H0, sizeof(state));
+    fill_block(block, &seed);
+
+    /* the counter counts down */
+    const uint32_t start = timer_getValue(SELFTEST_TIMER, SELFTEST_TIMER_COUNTER);
+
+    for (int i = 0; i < SELFTEST_BENCH_BLOCKS; i++)
+    {
+        func(state, block);
+    }
+
+    return start - timer_getValue(SELFTEST_TIMER, SELFTEST_TIMER_COUNTER);
+}
+
+static void benchmark(selftest_print_t print)
+{
+    char tmp[32] = { 0x00 };
+
+    timer_setLoad(SELFTEST_TIMER, SELFTEST_TIMER_COUNTER, 0xFFFFFFFF);
+    timer_start(SELFTEST_TIMER, SELFTEST_TIMER_COUNTER);
+
+    const uint32_t ticks_arm = time_blocks(&sha256_block_arm);
+    const uint32_t ticks_ref = time_blocks(&sha256_block_ref);
+
+    timer_stop(SELFTEST_TIMER, SELFTEST_TIMER_COUNTER);
+
+    print("# selftest: sha256 ");
+    print(my_itoa(SELFTEST_BENCH_BLOCKS, tmp, 10));
+    print(" blocks, asm ");
+    print(my_itoa(ticks_arm, tmp, 10));
+    print(" us, C ");
+    print(my_itoa(ticks_ref, tmp, 10));
+    print(" us\r\n");
+}
+
+int selftest_run(selftest_print_t print)
+{
+    int ret = check_kats(print, 0);
+    if (hash_isPresent())
+    {
+        ret |= check_kats(print, 1);
+    }
+    ret |= check_block_function(print);
+
+    benchmark(print);
+
+    return ret;
+}
+
+#endif /* CONFIG_SELFTEST */
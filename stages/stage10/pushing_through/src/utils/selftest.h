@@ -0,0 +1,34 @@
+#ifndef _SELFTEST_H_
+#define _SELFTEST_H_
+
+#include <stdint.h>
+
+/* Number of blocks compressed by each side of the SHA-256 benchmark */
+#define SELFTEST_BENCH_BLOCKS   ( 64 )
+
+/* Free running counter the benchmark is timed with (the tick uses timer 0) */
+#define SELFTEST_TIMER          ( 1 )
+#define SELFTEST_TIMER_COUNTER  ( 0 )
+
+/**
+ * Required prototype of the routine that emits the results, line by line.
+ */
+typedef void (*selftest_print_t)(const char* str);
+
+/**
+ * Checks the hashing primitives against known answers and benchmarks the
+ * SHA-256 block function:
+ *
+ *   - sha256() and hmac256() against the FIPS 180-4 and RFC 4231 vectors, in
+ *     software and, if it is present, on the SHA-256 accelerator
+ *   - sha256_block_arm() against a portable C block function, over pseudo random blocks
+ *   - the time both take for SELFTEST_BENCH_BLOCKS blocks, in timer ticks (us)
+ *
+ * Every result is emitted as a "# selftest: ..." line.
+ *
+ * @param print - routine used to output the results
+ * @return 0 if all checks passed, -1 otherwise
+ */
+int selftest_run(selftest_print_t print);
+
+#endif /* _SELFTEST_H_ */
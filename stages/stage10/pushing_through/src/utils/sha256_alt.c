@@ -0,0 +1,21 @@
+/* the context's state is private in mbedTLS 3.x */
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+
+#include <mbedtls/sha256.h>
+
+#ifdef MBEDTLS_SHA256_PROCESS_ALT
+
+#include "sha256_arm.h"
+
+/*
+ * Replaces the portable C block function of mbedTLS (see dev/mbedtls_config.h),
+ * everything above it (padding, buffering, HMAC, DRBG) is still mbedTLS's.
+ */
+int mbedtls_internal_sha256_process(mbedtls_sha256_context* ctx, const unsigned char data[64])
+{
+    sha256_block_arm(ctx->MBEDTLS_PRIVATE(state), data);
+
+    return 0;
+}
+
+#endif /* MBEDTLS_SHA256_PROCESS_ALT */
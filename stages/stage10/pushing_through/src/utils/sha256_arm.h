@@ -0,0 +1,17 @@
+#ifndef _SHA256_ARM_H_
+#define _SHA256_ARM_H_
+
+#include <stdint.h>
+
+/**
+ * Compresses a single 64 byte block into the SHA-256 state (FIPS 180-4, 6.2.2),
+ * hand scheduled for the ARM926EJ-S, see sha256_arm.s.
+ *
+ * mbedTLS uses it for all SHA-256 hashing through MBEDTLS_SHA256_PROCESS_ALT.
+ *
+ * @param state - the eight working words H0..H7, updated in place
+ * @param block - the message block, no alignment required
+ */
+void sha256_block_arm(uint32_t state[8], const uint8_t block[64]);
+
+#endif /* _SHA256_ARM_H_ */
@@ -0,0 +1,150 @@
+@ SHA-256 block function for ARMv5TE (ARM926EJ-S), see FIPS 180-4.
+@
+@ void sha256_block_arm(uint32_t state[8], const uint8_t block[64])
+@
+@ Compresses one 64 byte block into the state. The working variables a..h stay
+@ in r4-r11 for all 64 rounds: the rounds are unrolled eight times and each one
+@ renames the registers instead of moving them. The message schedule W[0..63]
+@ is expanded on the stack up front. All rotations are folded into the barrel
+@ shifter of the EOR/MOV that consumes them.
+@
+@ Register usage in the rounds:
+@   r0-r2   temporaries
+@   r3      end of the K table
+@   r4-r11  working variables
+@   r12     K[t]
+@   lr      W[t]
+
+.equ SHA256_SCHEDULE_SIZE, 256      @ 64 words of the message schedule
+.equ SHA256_STATE_OFFSET,  256      @ offset of the saved state pointer (r0) above the schedule
+
+@ one round, 'h' receives the new 'a' and 'd' the new 'e'
+.macro SHA256_ROUND a, b, c, d, e, f, g, h
+    LDR r0, [r12], #4               @ K[t]
+    LDR r1, [lr], #4                @ W[t]
+    ADD \h, \h, r0
+    ADD \h, \h, r1
+
+    EOR r0, \f, \g
+    AND r0, r0, \e
+    EOR r0, r0, \g                  @ Ch(e, f, g) = g ^ (e & (f ^ g))
+    ADD \h, \h, r0
+
+    MOV r0, \e, ROR #6
+    EOR r0, r0, \e, ROR #11
+    EOR r0, r0, \e, ROR #25         @ S1(e)
+    ADD \h, \h, r0                  @ h = T1
+
+    ADD \d, \d, \h                  @ e' = d + T1
+
+    MOV r0, \a, ROR #2
+    EOR r0, r0, \a, ROR #13
+    EOR r0, r0, \a, ROR #22         @ S0(a)
+    ADD \h, \h, r0
+
+    ORR r0, \a, \b
+    AND r0, r0, \c
+    AND r1, \a, \b
+    ORR r0, r0, r1                  @ Maj(a, b, c) = ((a | b) & c) | (a & b)
+    ADD \h, \h, r0                  @ a' = T1 + T2
+.endm
+
+.section .text
+.code 32
+
+.global sha256_block_arm
+sha256_block_arm:
+    STMFD sp!, {r0, r4-r11, lr}
+    SUB sp, sp, #SHA256_SCHEDULE_SIZE
+
+    @ W[0..15]: the block as big endian words, read bytewise as it may be unaligned
+    MOV lr, sp
+    ADD r3, sp, #64
+sha256_load_loop:
+    LDRB r4, [r1], #1
+    LDRB r5, [r1], #1
+    LDRB r6, [r1], #1
+    LDRB r7, [r1], #1
+    ORR r4, r5, r4, LSL #8
+    ORR r4, r6, r4, LSL #8
+    ORR r4, r7, r4, LSL #8
+    STR r4, [lr], #4
+    CMP lr, r3
+    BLO sha256_load_loop
+
+    @ W[16..63] = s1(W[t-2]) + W[t-7] + s0(W[t-15]) + W[t-16]
+    ADD r3, sp, #SHA256_SCHEDULE_SIZE
+sha256_schedule_loop:
+    LDR r4, [lr, #-60]              @ W[t-15]
+    LDR r5, [lr, #-8]               @ W[t-2]
+    LDR r6, [lr, #-28]              @ W[t-7]
+    LDR r7, [lr, #-64]              @ W[t-16]
+
+    MOV r0, r4, ROR #7
+    EOR r0, r0, r4, ROR #18
+    EOR r0, r0, r4, LSR #3          @ s0(W[t-15])
+
+    MOV r1, r5, ROR #17
+    EOR r1, r1, r5, ROR #19
+    EOR r1, r1, r5, LSR #10         @ s1(W[t-2])
+
+    ADD r0, r0, r1
+    ADD r0, r0, r6
+    ADD r0, r0, r7
+    STR r0, [lr], #4
+    CMP lr, r3
+    BLO sha256_schedule_loop
+
+    @ a..h = state
+    LDR r0, [sp, #SHA256_STATE_OFFSET]
+    LDMIA r0, {r4-r11}
+
+    LDR r12, =sha256_k
+    ADD r3, r12, #256
+    MOV lr, sp
+sha256_round_loop:
+    SHA256_ROUND r4, r5, r6, r7, r8, r9, r10, r11
+    SHA256_ROUND r11, r4, r5, r6, r7, r8, r9, r10
+    SHA256_ROUND r10, r11, r4, r5, r6, r7, r8, r9
+    SHA256_ROUND r9, r10, r11, r4, r5, r6, r7, r8
+    SHA256_ROUND r8, r9, r10, r11, r4, r5, r6, r7
+    SHA256_ROUND r7, r8, r9, r10, r11, r4, r5, r6
+    SHA256_ROUND r6, r7, r8, r9, r10, r11, r4, r5
+    SHA256_ROUND r5, r6, r7, r8, r9, r10, r11, r4
+    CMP r12, r3
+    BNE sha256_round_loop
+
+    @ state += a..h
+    LDR r0, [sp, #SHA256_STATE_OFFSET]
+    LDMIA r0, {r1-r3, r12}
+    ADD r4, r4, r1
+    ADD r5, r5, r2
+    ADD r6, r6, r3
+    ADD r7, r7, r12
+    STMIA r0!, {r4-r7}
+    LDMIA r0, {r1-r3, r12}
+    ADD r8, r8, r1
+    ADD r9, r9, r2
+    ADD r10, r10, r3
+    ADD r11, r11, r12
+    STMIA r0, {r8-r11}
+
+    ADD sp, sp, #SHA256_SCHEDULE_SIZE
+    LDMFD sp!, {r0, r4-r11, pc}
+
+.ltorg
+
+.section .rodata
+.align 2
+
+sha256_k:
+    .word 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5
+    .word 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174
+    .word 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da
+    .word 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967
+    .word 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85
+    .word 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070
+    .word 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3
+    .word 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+
+.end
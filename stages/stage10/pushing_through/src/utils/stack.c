@@ -0,0 +1,68 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "stack.h"
+
+/* boundaries of the stacks, provided by the linker script */
+extern uint32_t stack_bottom[];
+extern uint32_t stack_top[];
+extern uint32_t irq_stack_bottom[];
+extern uint32_t irq_stack_top[];
+
+static int8_t get_bounds(stack_id_t id, const volatile uint32_t** bottom, const volatile uint32_t** top)
+{
+    switch (id)
+    {
+        case (stack_svc):
+        {
+            *bottom = stack_bottom;
+            *top = stack_top;
+            return 0;
+        }
+        case (stack_irq):
+        {
+            *bottom = irq_stack_bottom;
+            *top = irq_stack_top;
+            return 0;
+        }
+        default:
+        {
+            return -1;
+        }
+    }
+
+    return -1;
+}
+
+size_t stack_size(stack_id_t id)
+{
+    const volatile uint32_t* bottom = NULL;
+    const volatile uint32_t* top = NULL;
+
+    if (get_bounds(id, &bottom, &top) != 0)
+    {
+        return 0;
+    }
+
+    return (top - bottom) * sizeof(uint32_t);
+}
+
+size_t stack_high_watermark(stack_id_t id)
+{
+    const volatile uint32_t* bottom = NULL;
+    const volatile uint32_t* top = NULL;
+
+    if (get_bounds(id, &bottom, &top) != 0)
+    {
+        return 0;
+    }
+
+    /* the stacks grow downwards, so the untouched words are at the bottom */
+    const volatile uint32_t* p = bottom;
+    while ((p < top) && (*p == STACK_PAINT_PATTERN))
+    {
+        p++;
+    }
+
+    return (top - p) * sizeof(uint32_t);
+}
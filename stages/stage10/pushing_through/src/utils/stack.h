@@ -0,0 +1,37 @@
+#ifndef _STACK_H_
+#define _STACK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Pattern the stacks are painted with at reset, must match startup.s */
+#define STACK_PAINT_PATTERN    ( 0xDEADBEEF )
+
+typedef enum
+{
+    stack_svc = 0,      /* "Supervisor" mode stack, used by init(), main() and the tasks */
+    stack_irq           /* "IRQ" mode stack, used by irq_handler() and the ISRs */
+} stack_id_t;
+
+/**
+ * Returns the size of the stack reserved by the linker script.
+ *
+ * @param id - the stack
+ * @return size of the stack in bytes, 0 if 'id' is invalid
+ */
+size_t stack_size(stack_id_t id);
+
+/**
+ * Returns the deepest usage of the stack since reset, found as the lowest
+ * word that does not hold the paint pattern anymore.
+ *
+ * It is a lower bound: a frame that happened to store the pattern at its
+ * deepest word is not counted. A value equal to stack_size() means the stack
+ * has (most likely) overflowed.
+ *
+ * @param id - the stack
+ * @return high watermark in bytes, 0 if 'id' is invalid
+ */
+size_t stack_high_watermark(stack_id_t id);
+
+#endif /* _STACK_H_ */
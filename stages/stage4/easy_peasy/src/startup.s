@@ -1,5 +1,7 @@
 .org 0
 
+.include "halt.inc"
+
 .section .init
 .code 32
 
@@ -7,6 +9,6 @@
 entry_point:
     LDR sp, =stack_top
     BL main
-    B .
+    HALT
 
 .end
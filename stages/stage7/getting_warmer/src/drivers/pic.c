@@ -69,9 +69,13 @@ void irq_enableIrqMode(void)
      * must be cleared to 0. See pp. 2-15 to 2-17 of the DDI0222 for more details.
      * The CSPR can only be accessed using assembler.
      */
-    __asm volatile("MRS r0, cpsr");        /* Read in the CPSR register. */
-    __asm volatile("BIC r0, r0, #0x80");   /* Clear bit 8, (0x80) -- Causes IRQs to be enabled. */
-    __asm volatile("MSR cpsr_c, r0");      /* Write it back to the CPSR register */
+    uint32_t cpsr;
+
+    /* a single statement, so that the compiler allocates the register and keeps the order */
+    __asm volatile("MRS %0, cpsr\n"          /* Read in the CPSR register. */
+                   "BIC %0, %0, #0x80\n"     /* Clear bit 8, (0x80) -- Causes IRQs to be enabled. */
+                   "MSR cpsr_c, %0"          /* Write it back to the CPSR register */
+                   : "=&r" (cpsr) : : "memory");
 }
 
 void irq_disableIrqMode(void)
@@ -81,9 +85,12 @@ void irq_disableIrqMode(void)
      * must be set t1 0. See pp. 2-15 to 2-17 of the DDI0222 for more details.
      * The CSPR can only be accessed using assembler.
      */
-    __asm volatile("MRS r0, cpsr");       /* Read in the CPSR register. */
-    __asm volatile("ORR r0, r0, #0xC0");  /* Disable IRQ and FIQ exceptions. */
-    __asm volatile("MSR cpsr_c, r0");     /* Write it back to the CPSR register. */
+    uint32_t cpsr;
+
+    __asm volatile("MRS %0, cpsr\n"          /* Read in the CPSR register. */
+                   "ORR %0, %0, #0xC0\n"     /* Disable IRQ and FIQ exceptions. */
+                   "MSR cpsr_c, %0"          /* Write it back to the CPSR register. */
+                   : "=&r" (cpsr) : : "memory");
 }
 
 /*